@@ -9,6 +9,8 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/kernel.h>
 
+#include <string.h>
+
 #include "dw3000_spi.h"
 
 /* This file implements the SPI functions required by decadriver */
@@ -25,6 +27,31 @@ static struct spi_cs_control cs_ctrl = SPI_CS_CONTROL_INIT(DT_NODELABEL(dwm3000)
 static struct spi_config spi_cfgs[2] = {0}; // configs for slow and fast
 static struct spi_config* spi_cfg;
 
+#ifdef CONFIG_DW3000_SPI_ASYNC
+/*
+ * Deferred read: the decadriver only knows the blocking readfromspi callback.
+ * When a deferred read is armed, the next read with at least min_length bytes
+ * (e.g. the accumulator data of dwt_readaccdata) is only started and the
+ * callback returns immediately. The SPI driver keeps the bus locked until the
+ * EasyDMA transfer is done, so any further SPI access blocks until then.
+ */
+static struct k_poll_signal* async_signal;
+static uint16_t async_min_length;
+
+/*
+ * The SPI driver uses the buffer descriptors until the transfer is done, so
+ * they and a copy of the header (a stack buffer of the decadriver) are owned
+ * by the deferred read. Only one deferred read is in flight at a time.
+ */
+#define ASYNC_MAX_HEADER_LEN 4
+
+static uint8_t async_header[ASYNC_MAX_HEADER_LEN];
+static struct spi_buf async_tx_buf;
+static struct spi_buf_set async_tx;
+static struct spi_buf async_rx_buf[2];
+static struct spi_buf_set async_rx;
+#endif
+
 int dw3000_spi_init(void)
 {
 	/* set common SPI config */
@@ -126,6 +153,42 @@ int dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
 	return spi_transceive(spi, spi_cfg, &tx, NULL);
 }
 
+#ifdef CONFIG_DW3000_SPI_ASYNC
+void dw3000_spi_read_defer(uint16_t minLength, struct k_poll_signal* signal)
+{
+	k_poll_signal_reset(signal);
+	async_min_length = minLength;
+	async_signal = signal;
+}
+
+int dw3000_spi_read_wait(struct k_poll_signal* signal, k_timeout_t timeout)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL,
+														 K_POLL_MODE_NOTIFY_ONLY,
+														 signal);
+	unsigned int signaled;
+	int result;
+
+	int ret = k_poll(&event, 1, timeout);
+	if (ret) {
+		return ret;
+	}
+	k_poll_signal_check(signal, &signaled, &result);
+	k_poll_signal_reset(signal);
+
+#if (CONFIG_SOC_NRF52840_QIAA)
+	/* same workaround as for the blocking read, see dw3000_spi_read */
+	if (result == 0) {
+		for (volatile int i = 0; i < TX_WAIT_RESP_NRF52840_DELAY; i++) {
+			/* spin */
+		}
+	}
+#endif
+
+	return result;
+}
+#endif
+
 int dw3000_spi_read(uint16_t headerLength, uint8_t* headerBuffer,
 					uint16_t readLength, uint8_t* readBuffer)
 {
@@ -152,6 +215,40 @@ int dw3000_spi_read(uint16_t headerLength, uint8_t* headerBuffer,
 		.count = ARRAY_SIZE(rx_buf),
 	};
 
+#ifdef CONFIG_DW3000_SPI_ASYNC
+	if (async_signal && readLength >= async_min_length
+			&& headerLength <= ASYNC_MAX_HEADER_LEN) {
+		struct k_poll_signal* signal = async_signal;
+		async_signal = NULL;
+		memcpy(async_header, headerBuffer, headerLength);
+		async_tx_buf = (struct spi_buf){
+			.buf = async_header,
+			.len = headerLength,
+		};
+		async_tx = (struct spi_buf_set){
+			.buffers = &async_tx_buf,
+			.count = 1,
+		};
+		async_rx_buf[0] = (struct spi_buf){
+			.buf = NULL,
+			.len = headerLength,
+		};
+		async_rx_buf[1] = (struct spi_buf){
+			.buf = readBuffer,
+			.len = readLength,
+		};
+		async_rx = (struct spi_buf_set){
+			.buffers = async_rx_buf,
+			.count = ARRAY_SIZE(async_rx_buf),
+		};
+		int ret = spi_transceive_signal(spi, spi_cfg, &async_tx, &async_rx, signal);
+		if (ret) {
+			k_poll_signal_raise(signal, ret);
+		}
+		return ret;
+	}
+#endif
+
 	int ret = spi_transceive(spi, spi_cfg, &tx, &rx);
 
 #if (CONFIG_SOC_NRF52840_QIAA)
@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <zephyr/kernel.h>
 
 int dw3000_spi_init(void);
 void dw3000_spi_fini(void);
@@ -19,6 +20,16 @@ int dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
 int dw3000_spi_write_crc(uint16_t headerLength, const uint8_t* headerBuffer,
 						 uint16_t bodyLength, const uint8_t* bodyBuffer,
 						 uint8_t crc8);
+#ifdef CONFIG_DW3000_SPI_ASYNC
+/*
+ * Start the next read with at least minLength bytes asynchronously (EasyDMA)
+ * and raise signal when it is done. All shorter reads stay blocking. The read
+ * buffer must outlive the call (static or owned by the caller until the wait)
+ * and must not be used before dw3000_spi_read_wait returned.
+ */
+void dw3000_spi_read_defer(uint16_t minLength, struct k_poll_signal* signal);
+int dw3000_spi_read_wait(struct k_poll_signal* signal, k_timeout_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -42,8 +42,29 @@
 #include <zephyr/kernel.h>
 #include <deca_device_api.h>
 
+#include "sit_config.h"
+
 #define SPEED_OF_LIGHT 299702547
-extern uint32_t measurements;
+
+/**
+ * Ranging state of one role. Every role (initiator, responder, survey,
+ * all-pairs) has its own session, so a device can run several roles
+ * interleaved without overwriting the results of the other one.
+ */
+typedef struct {
+    uint32_t sequence;      ///< ranging cycle of this role
+    uint32_t measurements;  ///< distances notified over BLE
+    double distance;        ///< last distance in meter
+    double time_round_1;    ///< time intervals of the last exchange in DWT time units
+    double time_round_2;
+    double time_reply_1;
+    double time_reply_2;
+    double clock_offset;    ///< clock offset ratio of the last exchange, positive: remote clock faster
+} sit_session_t;
+
+extern sit_session_t initiator_session;
+extern sit_session_t responder_session;
+
 /***************************************************************************
 * Initilization for DW3001 -> SPI Connection, DW3000, Antenna Delay  
 *
@@ -55,12 +76,87 @@ extern uint32_t measurements;
 * ]
 ****************************************************************************/
 uint8_t sit_init();
+
+/***************************************************************************
+* Reset and configure the DW3000 again, e.g. after it lost its
+* configuration in deep sleep. Unlike sit_init() the device setup, the
+* temperature reference and the XTAL trim controller are kept.
+*
+* @return 1 on success, error code of sit_init() otherwise
+****************************************************************************/
+uint8_t sit_reconfigure();
 void sit_run_forever();
 
+/***************************************************************************
+ * Notify the last distance of a session over BLE (distance_msg).
+ *
+ * @param sit_session_t* session -> session with the distance
+ * @param uint8_t responder -> device id of the responder
+ *
+ * @return None
+ *
+****************************************************************************/
+void send_twr_notify(sit_session_t *session, sit_addr_t responder);
+
 void sit_sstwr_initiator();
-void sit_sstwr_responder();
+
+/***************************************************************************
+ * One SS-TWR exchange as initiator: poll and wait for the response with 
+ * the 40 bit timestamps of the responder. The clock offset is corrected 
+ * with the carrier integrator, the result is stored in the session.
+ *
+ * @param sit_session_t* session -> initiator session
+ * @param uint8_t responder_id -> device id of the responder
+ *
+ * @return bool true  -> if the distance is valid
+ *
+****************************************************************************/
+bool sit_sstwr_poll(sit_session_t *session, sit_addr_t responder_id);
+
+/***************************************************************************
+ * Send the SS-TWR response CONFIG_SIT_SSTWR_REPLY_UUS after the poll.
+ *
+ * @param msg_simple_t* rx_poll_msg -> the received poll msg
+ *
+ * @return bool true  -> if the response is send
+ *
+****************************************************************************/
+bool sit_sstwr_response(msg_simple_t *rx_poll_msg);
+
+/***************************************************************************
+ * Alternate SS-TWR and DS-TWR every cycle and report rate and spread of 
+ * both modes. The SS-TWR statistics are logged by the initiator, the 
+ * DS-TWR statistics by the responder.
+ *
+****************************************************************************/
+void sit_twr_compare_initiator();
 
 void sit_dstwr_initiator(); 
 void sit_dstwr_responder();
 
+/***************************************************************************
+ * One DS-TWR exchange as initiator: poll, wait for the response and send 
+ * the final msg. The distance is calculated at the responder.
+ *
+ * @param sit_session_t* session -> initiator session
+ * @param uint8_t responder_id -> device id of the responder
+ *
+ * @return bool true  -> if the final msg is send
+ *         bool false -> on timeout or a late final msg
+ *
+****************************************************************************/
+bool sit_dstwr_poll(sit_session_t *session, sit_addr_t responder_id);
+
+/***************************************************************************
+ * One DS-TWR exchange as responder after a poll msg is received, stores 
+ * the result in the session.
+ *
+ * @param sit_session_t* session -> responder session
+ * @param msg_simple_t* rx_poll_msg -> the received poll msg
+ *
+ * @return bool true  -> if the distance is valid
+ *
+****************************************************************************/
+bool sit_dstwr_response(sit_session_t *session, msg_simple_t *rx_poll_msg);
+
 void reset_sequence();
@@ -0,0 +1,136 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_all_pairs.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the all-pairs ranging solver (ds_all_twr).
+ *
+ * Every node broadcasts one frame per round in its own slot. The frame
+ * carries its TX timestamp and the RX timestamps of the last frame of every
+ * other node: nodes with a lower slot from this round, nodes with a higher
+ * slot from the last round. For a pair a < b the frames of round r and
+ * r + 1 form a DS-TWR exchange:
+ *
+ *   poll  -> frame of a in round r
+ *   resp  -> frame of b in round r
+ *   final -> frame of a in round r + 1
+ *
+ * and every node which hears a and b calculates their distance, so a round
+ * of N frames gives all N * (N - 1) / 2 distances.
+ *
+ * The module has no Zephyr dependencies, a host simulation is in
+ * lib/sit/sim/sit_all_twr_sim.c.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_ALL_PAIRS_H__
+#define __SIT_ALL_PAIRS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_ALL_TWR_MAX_NODES
+#define CONFIG_SIT_ALL_TWR_MAX_NODES 8
+#endif
+
+#define SIT_ALL_PAIRS_MAX_NODES CONFIG_SIT_ALL_TWR_MAX_NODES
+#define SIT_ALL_PAIRS_TS_LEN    5 // 40 bit timestamps
+/** round + tx timestamp + heard mask + rx timestamps */
+#define SIT_ALL_PAIRS_MAX_PAYLOAD (1 + SIT_ALL_PAIRS_TS_LEN + 4 + SIT_ALL_PAIRS_MAX_NODES * SIT_ALL_PAIRS_TS_LEN)
+
+typedef struct {
+    uint8_t node;
+    uint8_t round;
+    uint64_t tx_ts;
+    uint32_t heard;                         ///< bit j -> rx_ts[j] is valid
+    uint64_t rx_ts[SIT_ALL_PAIRS_MAX_NODES];
+} sit_all_pairs_frame_t;
+
+typedef struct {
+    uint8_t node;                           ///< own slot
+    uint8_t nodes;
+    uint64_t rx_ts[SIT_ALL_PAIRS_MAX_NODES];  ///< last reception of every node
+    uint8_t rx_round[SIT_ALL_PAIRS_MAX_NODES];
+    uint32_t rx_valid;
+    sit_all_pairs_frame_t frames[SIT_ALL_PAIRS_MAX_NODES][2]; ///< last two rounds per node
+    uint8_t frames_valid[SIT_ALL_PAIRS_MAX_NODES];            ///< bit 0/1 -> frames[][0/1]
+} sit_all_pairs_t;
+
+/***************************************************************************
+ * Start with empty tables.
+ *
+ * @param node      -> own slot (0..nodes-1)
+ * @param nodes     -> number of nodes (2..SIT_ALL_PAIRS_MAX_NODES)
+ *
+ * @return false if the parameters are out of range
+ *
+****************************************************************************/
+bool sit_all_pairs_init(sit_all_pairs_t *ctx, uint8_t node, uint8_t nodes);
+
+/***************************************************************************
+ * Build the own frame of a round and keep it for the distance calculation.
+ *
+ * @param tx_ts     -> TX timestamp of the frame (known from the delayed TX)
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_all_pairs_build(sit_all_pairs_t *ctx, uint8_t round, uint64_t tx_ts, sit_all_pairs_frame_t *frame);
+
+/***************************************************************************
+ * Store a received frame.
+ *
+ * @param rx_ts     -> own RX timestamp of the frame
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_all_pairs_receive(sit_all_pairs_t *ctx, const sit_all_pairs_frame_t *frame, uint64_t rx_ts);
+
+/***************************************************************************
+ * Time of flight between two nodes from the last two complete rounds.
+ *
+ * @param tof_dtu   -> time of flight in DWT time units
+ *
+ * @return true if all six timestamps are available
+ *
+****************************************************************************/
+bool sit_all_pairs_tof(const sit_all_pairs_t *ctx, uint8_t a, uint8_t b, double *tof_dtu);
+
+/***************************************************************************
+ * Serialize a frame (only the heard rx timestamps are sent).
+ *
+ * @return payload length in bytes
+ *
+****************************************************************************/
+uint16_t sit_all_pairs_pack(const sit_all_pairs_frame_t *frame, uint8_t *buffer);
+
+/***************************************************************************
+ * Deserialize a frame.
+ *
+ * @return false if the payload is too short
+ *
+****************************************************************************/
+bool sit_all_pairs_unpack(const uint8_t *buffer, uint16_t length, uint8_t node, sit_all_pairs_frame_t *frame);
+
+#endif // __SIT_ALL_PAIRS_H__
@@ -0,0 +1,63 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_all_twr.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the all-pairs ranging mode (ds_all_twr).
+ *
+ * The nodes 100 .. device_settings.responder broadcast one frame per round
+ * in a fixed slot (node 100 first), the solver in sit_all_pairs.h
+ * calculates every pairwise distance from these frames. Node 100 keeps the
+ * round time, all other nodes align their slot to every frame they hear.
+ * The same rounds are used for the extended antenna delay calibration.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_ALL_TWR_H__
+#define __SIT_ALL_TWR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Device id of the node with the first slot, it starts the rounds */
+#define SIT_ALL_TWR_FIRST_ID 100
+
+/***************************************************************************
+ * Run the all-pairs ranging on a node, returns when the device state
+ * changes to sleep.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_all_twr_run(void);
+
+/***************************************************************************
+ * Set the known position of a node (100 + index) for the extended
+ * calibration, all nodes need a position.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_all_twr_set_calibration_position(uint8_t index, float x, float y, float z);
+
+#endif // __SIT_ALL_TWR_H__
@@ -0,0 +1,112 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_anchor_select.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the anchor subset selection.
+ *
+ * Picks the best K anchors for the next ranging cycle from the current
+ * position estimate, the geometric dilution of precision (GDOP) and the
+ * link quality of every anchor. A host check against a brute force search
+ * is in lib/sit/sim/sit_anchor_select_sim.c.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_ANCHOR_SELECT_H__
+#define __SIT_ANCHOR_SELECT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sit_position.h"
+
+#ifndef CONFIG_SIT_ANCHOR_SELECT_K
+#define CONFIG_SIT_ANCHOR_SELECT_K 4
+#endif
+
+#ifndef CONFIG_SIT_ANCHOR_SELECT_FULL_CYCLE
+#define CONFIG_SIT_ANCHOR_SELECT_FULL_CYCLE 10
+#endif
+
+/** Anchors below this link quality are never selected. */
+#define SIT_ANCHOR_MIN_QUALITY 0.05f
+
+/***************************************************************************
+ * Weighted GDOP of an anchor subset seen from a position.
+ *
+ * Every anchor contributes its unit vector weighted with its link quality,
+ * the result is sqrt(trace((H^T W H)^-1)).
+ *
+ * @param anchors       -> coordinates of all anchors
+ * @param link_quality  -> link quality of all anchors (0..1)
+ * @param subset        -> indices of the anchors in the subset
+ * @param count         -> number of anchors in the subset
+ * @param position      -> current position estimate
+ * @param solve_3d      -> use x/y/z, otherwise only x/y
+ *
+ * @return GDOP, FLT_MAX if the geometry is singular
+ *
+****************************************************************************/
+float sit_anchor_gdop(
+    const sit_vec3_t *anchors,
+    const float *link_quality,
+    const uint8_t *subset,
+    uint8_t count,
+    const sit_vec3_t *position,
+    bool solve_3d
+);
+
+/***************************************************************************
+ * Select the best k anchors.
+ *
+ * Greedy forward selection on the (regularised) weighted GDOP followed
+ * by one pass of pairwise swaps, so the cost is bounded by
+ * O(k * count) GDOP evaluations.
+ *
+ * @param selected      -> output array with at least k entries
+ *
+ * @return number of selected anchors (<= k)
+ *
+****************************************************************************/
+uint8_t sit_anchor_select(
+    const sit_vec3_t *anchors,
+    const float *link_quality,
+    uint8_t count,
+    const sit_vec3_t *position,
+    bool solve_3d,
+    uint8_t k,
+    uint8_t *selected
+);
+
+/***************************************************************************
+ * Update the link quality of an anchor after a ranging attempt.
+ *
+ * @param quality   -> link quality of the anchor, updated in place
+ * @param success   -> true if the exchange delivered a distance
+ * @param nlos      -> NLOS percentage from the diagnostic (0..100)
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_anchor_link_update(float *quality, bool success, uint8_t nlos);
+
+#endif // __SIT_ANCHOR_SELECT_H__
@@ -0,0 +1,98 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_backoff.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the random backoff for the channel access with CCA.
+ *
+ * Unslotted CSMA-CA as in IEEE 802.15.4: before the first CCA and after
+ * every busy channel the initiator waits a random number of backoff
+ * periods in 0 .. 2^BE - 1. BE starts at CONFIG_SIT_CCA_MIN_BE and grows
+ * with every busy CCA up to CONFIG_SIT_CCA_MAX_BE, after
+ * CONFIG_SIT_CCA_MAX_BACKOFFS busy CCAs the poll is dropped.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_BACKOFF_H__
+#define __SIT_BACKOFF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_CCA_MIN_BE
+#define CONFIG_SIT_CCA_MIN_BE 2
+#endif
+
+#ifndef CONFIG_SIT_CCA_MAX_BE
+#define CONFIG_SIT_CCA_MAX_BE 5
+#endif
+
+#ifndef CONFIG_SIT_CCA_MAX_BACKOFFS
+#define CONFIG_SIT_CCA_MAX_BACKOFFS 4
+#endif
+
+typedef struct {
+    uint8_t backoffs;   ///< busy CCAs of the current poll (NB)
+    uint8_t exponent;   ///< backoff exponent (BE)
+} sit_backoff_t;
+
+typedef struct {
+    uint32_t polls;         ///< polls with channel access
+    uint32_t busy;          ///< CCAs which detected a preamble
+    uint32_t retries;       ///< CCAs repeated after a backoff
+    uint32_t dropped;       ///< polls dropped after CONFIG_SIT_CCA_MAX_BACKOFFS
+    uint32_t no_response;   ///< polls sent on a clear channel without a response
+    uint32_t backoff_periods; ///< sum of all backoff periods
+} sit_backoff_stats_t;
+
+/***************************************************************************
+ * Start the channel access of a poll.
+ *
+ * @param random    -> random number
+ *
+ * @return backoff periods before the first CCA
+ *
+****************************************************************************/
+uint32_t sit_backoff_start(sit_backoff_t *backoff, sit_backoff_stats_t *stats, uint32_t random);
+
+/***************************************************************************
+ * The CCA detected a preamble.
+ *
+ * @param random    -> random number
+ *
+ * @return backoff periods before the next CCA, -1 if the poll is dropped
+ *
+****************************************************************************/
+int32_t sit_backoff_busy(sit_backoff_t *backoff, sit_backoff_stats_t *stats, uint32_t random);
+
+/***************************************************************************
+ * Result of a poll sent on a clear channel.
+ *
+ * @param response  -> the response was received
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_backoff_result(sit_backoff_stats_t *stats, bool response);
+
+#endif // __SIT_BACKOFF_H__
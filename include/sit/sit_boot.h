@@ -0,0 +1,64 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_boot.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the boot phase timestamps.
+ *
+ * Every boot phase is marked once with the uptime in microseconds. When
+ * the first distance is measured all phases and the boot-to-first-range
+ * latency are logged.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_BOOT_H__
+#define __SIT_BOOT_H__
+
+#include <stdint.h>
+
+typedef enum {
+    boot_main,          ///< main() entered
+    boot_led,           ///< LEDs configured
+    boot_settings,      ///< persistent settings restored
+    boot_ble,           ///< BLE stack ready
+    boot_uwb,           ///< DW3000 initialized
+    boot_first_range,   ///< first distance measured
+    boot_phases,
+} sit_boot_phase_t;
+
+/***************************************************************************
+ * Mark a boot phase, only the first mark of every phase is stored.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_boot_mark(sit_boot_phase_t phase);
+
+/***************************************************************************
+ * Get the timestamp of a boot phase.
+ *
+ * @return uptime in us, 0 if the phase is not reached yet
+ *
+****************************************************************************/
+uint32_t sit_boot_get(sit_boot_phase_t phase);
+
+#endif // __SIT_BOOT_H__
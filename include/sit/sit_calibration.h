@@ -0,0 +1,201 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_calibration.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the three device antenna delay solver.
+ *
+ * Device A polls B, B answers and A sends a final msg (DS-TWR). Device C
+ * receives all three frames passively. With the known distances between
+ * A, B and C every round gives three observations of the antenna delay 
+ * errors (in DWT time units):
+ *  - e_a  -> reply time of A seen by C minus the reply time of A
+ *  - e_b  -> reply time of B seen by C minus the reply time of B
+ *  - e_ab -> DS-TWR round trip minus the true round trip, e_a + e_b
+ * Reply times are corrected by the clock drift to C. The rounds are 
+ * accumulated with Welford estimators, the solver is a least-squares over
+ * the three means.
+ *
+ * The extended calibration (sit_calibration_n_*) uses the all-pairs
+ * ranging of N devices with known positions. Every pair i, j gives the
+ * observation e_ij = d_i + d_j (measured minus true round trip), the
+ * delays of all devices are solved jointly with weighted least squares,
+ * the weight of a pair is the inverse variance of its mean.
+ *
+ * A host benchmark of the solver is in lib/sit/sim/sit_calibration_bench.c.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_CALIBRATION_H__
+#define __SIT_CALIBRATION_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_CALIBRATION_ROUNDS
+#define CONFIG_SIT_CALIBRATION_ROUNDS 100
+#endif
+
+#ifndef CONFIG_SIT_ALL_TWR_MAX_NODES
+#define CONFIG_SIT_ALL_TWR_MAX_NODES 8
+#endif
+
+/** Rounds with a clock drift above this are discarded (100 ppm) */
+#define SIT_CALIBRATION_MAX_DRIFT 1e-4
+
+#define SIT_CALIBRATION_MAX_DEVICES CONFIG_SIT_ALL_TWR_MAX_NODES
+#define SIT_CALIBRATION_MAX_PAIRS (SIT_CALIBRATION_MAX_DEVICES * (SIT_CALIBRATION_MAX_DEVICES - 1) / 2)
+/** Pair errors above this are discarded (DWT time units, ~4.7 m round trip) */
+#define SIT_CALIBRATION_MAX_ERROR 1000.0
+
+typedef struct {
+    uint32_t n;
+    double mean;
+    double m2;
+} sit_welford_t;
+
+/** Time intervals of one round in DWT time units, names as in sit.c */
+typedef struct {
+    double time_m21; ///< A: sensing 2 rx - sensing 1 tx
+    double time_m31; ///< A: sensing 3 tx - sensing 1 tx
+    double time_a21; ///< B: sensing 2 tx - sensing 1 rx
+    double time_a31; ///< B: sensing 3 rx - sensing 1 rx
+    double time_b21; ///< C: sensing 2 rx - sensing 1 rx
+    double time_b31; ///< C: sensing 3 rx - sensing 1 rx
+} sit_calibration_round_t;
+
+typedef struct {
+    double tof_ab; ///< true time of flight A-B in DWT time units
+    double tof_ac;
+    double tof_bc;
+    sit_welford_t e_a;
+    sit_welford_t e_b;
+    sit_welford_t e_ab;
+} sit_calibration_t;
+
+typedef struct {
+    int16_t delay_a;   ///< antenna delay error of A (tx + rx) in DWT time units
+    int16_t delay_b;   ///< antenna delay error of B (tx + rx) in DWT time units
+    float std_a;       ///< standard error of delay_a
+    float std_b;       ///< standard error of delay_b
+    uint32_t rounds;
+} sit_calibration_result_t;
+
+typedef struct {
+    uint8_t devices;
+    float tof[SIT_CALIBRATION_MAX_PAIRS];              ///< true time of flight in DWT time units
+    sit_welford_t error[SIT_CALIBRATION_MAX_PAIRS];    ///< measured - true round trip
+} sit_calibration_n_t;
+
+typedef struct {
+    int16_t delay[SIT_CALIBRATION_MAX_DEVICES]; ///< antenna delay error (tx + rx) in DWT time units
+    float std[SIT_CALIBRATION_MAX_DEVICES];     ///< standard error of delay
+    float rms;                                  ///< RMS of the pair residuals in DWT time units
+    uint16_t pairs;                             ///< pairs used for the solution
+    uint32_t rounds;                            ///< samples of the weakest used pair
+} sit_calibration_n_result_t;
+
+/***************************************************************************
+ * Add a sample to a Welford estimator (online mean and variance)
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_welford_add(sit_welford_t *welford, double value);
+
+/***************************************************************************
+ * Sample variance of a Welford estimator, 0 with less than two samples
+ *
+****************************************************************************/
+double sit_welford_variance(const sit_welford_t *welford);
+
+/***************************************************************************
+ * Reset the estimators and set the true time of flight between the devices
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_calibration_reset(sit_calibration_t *calibration, double tof_ab, double tof_ac, double tof_bc);
+
+/***************************************************************************
+ * Add one round to the estimators
+ *
+ * @return true  -> if the round is used
+ *         false -> if the clock drift of the round is implausible
+ *
+****************************************************************************/
+bool sit_calibration_add(sit_calibration_t *calibration, const sit_calibration_round_t *round);
+
+/***************************************************************************
+ * Solve the antenna delay errors of A and B. The new antenna delay of a
+ * device is the current (tx + rx) plus the error, split equally to tx 
+ * and rx.
+ *
+ * @return true  -> if CONFIG_SIT_CALIBRATION_ROUNDS rounds are accumulated
+ *
+****************************************************************************/
+bool sit_calibration_solve(const sit_calibration_t *calibration, sit_calibration_result_t *result);
+
+/***************************************************************************
+ * Reset the extended calibration for devices 0..devices-1
+ *
+ * @return false if devices is out of range (3..SIT_CALIBRATION_MAX_DEVICES)
+ *
+****************************************************************************/
+bool sit_calibration_n_reset(sit_calibration_n_t *calibration, uint8_t devices);
+
+/***************************************************************************
+ * Set the true time of flight between two devices
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_calibration_n_set_tof(sit_calibration_n_t *calibration, uint8_t a, uint8_t b, double tof);
+
+/***************************************************************************
+ * Add a measured time of flight between two devices
+ *
+ * @param tof   -> measured time of flight in DWT time units
+ *
+ * @return true  -> if the sample is used
+ *         false -> if the pair has no true distance or the error is above
+ *                  SIT_CALIBRATION_MAX_ERROR
+ *
+****************************************************************************/
+bool sit_calibration_n_add(sit_calibration_n_t *calibration, uint8_t a, uint8_t b, double tof);
+
+/***************************************************************************
+ * Solve the antenna delay errors of all devices from every pair with at
+ * least min_rounds samples. The delays are only determined if the pairs
+ * connect all devices and contain a triangle (a graph with an odd cycle),
+ * with pairs only between two groups d_i + c, d_j - c fits as well.
+ *
+ * @return true  -> if all delays are determined
+ *
+****************************************************************************/
+bool sit_calibration_n_solve(
+    const sit_calibration_n_t *calibration,
+    uint32_t min_rounds,
+    sit_calibration_n_result_t *result
+);
+
+#endif // __SIT_CALIBRATION_H__
@@ -0,0 +1,88 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_cir.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the CIR capture and streaming mode.
+ *
+ * After every CONFIG_SIT_CIR_EVERY ranging exchange the responder reads a
+ * window of the accumulator around the first path of the final message,
+ * compresses it to int16 I/Q with one exponent per block and streams the
+ * blocks as BLE notify fragments. The data is used to train NLOS models
+ * offline.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_CIR_H__
+#define __SIT_CIR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <zephyr/toolchain.h>
+
+#define SIT_CIR_ACCUM_TAPS      1016 // accumulator length for PRF 64 MHz
+#define SIT_CIR_FRAGMENT_TYPE   0xC1 // first byte, JSON notifies start with '{'
+
+/* One block of the CIR, sample = iq << exponent */
+typedef struct {
+    uint8_t type;
+    int8_t exponent;
+    uint16_t fragment;
+    uint16_t fragments;
+    uint16_t capture;       ///< capture counter
+    uint16_t first_tap;     ///< accumulator index of iq[0]
+    uint16_t fp_index;      ///< first path index (10.6 fixed point)
+    uint32_t sequence;      ///< ranging sequence, to join with the distance
+    int16_t iq[2 * CONFIG_SIT_CIR_BLOCK_TAPS]; ///< I, Q interleaved
+} __packed sit_cir_fragment_t;
+
+typedef struct {
+    uint32_t captures;      ///< CIRs read from the accumulator
+    uint32_t streamed;      ///< CIRs completely sent
+    uint32_t skipped;       ///< selected frames while the last CIR was still sent
+    uint32_t capture_us;    ///< duration of the last accumulator read
+} sit_cir_stats_t;
+
+/***************************************************************************
+ * Capture the CIR of the last received frame if the frame is selected.
+ *
+ * Must be called after the ranging exchange, before the receiver is
+ * enabled again. The streaming runs in the system work queue.
+ *
+ * @param sequence  -> sequence of the ranging exchange
+ *
+ * @return true if a CIR was captured
+ *
+****************************************************************************/
+bool sit_cir_capture(uint32_t sequence);
+
+/***************************************************************************
+ * Get the capture statistics.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_cir_get_stats(sit_cir_stats_t *stats);
+
+#endif // __SIT_CIR_H__
@@ -37,6 +37,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include <zephyr/toolchain.h>
+
 #include <deca_device_api.h>
 
 #include <sit_json/sit_json_config.h>
@@ -68,17 +70,28 @@ typedef enum {
     ss_twr,
     ds_3_twr,
     ds_4_twr, ///< not Implemented yet 
-    ds_all_twr, ///< not Implemnted yet
+    ds_all_twr, ///< every node broadcasts once per round, all pairwise distances
     simple_calibration,
-    extended_calibration,
+    extended_calibration, ///< antenna delays of N nodes from all-pairs ranging
     two_device_calibration,
+    anchor_survey,
+    twr_compare, ///< initiator alternates SS-TWR and DS-TWR every cycle
 } measurement_type_t;
 
+/** 
+ * Device address, tags below 100, anchors at 100 (100 + index)
+*/
+typedef uint16_t sit_addr_t;
+
+#define SIT_ADDR_BROADCAST 0xFFFF
+/** Tags use the addresses 1..SIT_TAG_ADDR_MAX, below the first anchor */
+#define SIT_TAG_ADDR_MAX 99
+
 typedef struct {
-    uint8_t deviceID;
+    sit_addr_t deviceID;
     uint8_t devices;
-    uint8_t initiator; 
-    uint8_t responder;
+    sit_addr_t initiator; 
+    sit_addr_t responder; ///< highest anchor address
     uint16_t tx_ant_dly;
     uint16_t rx_ant_dly;
     device_type_t device_type;
@@ -87,6 +100,9 @@ typedef struct {
     bool diagnostic;
     uint32_t min_measurement;
     uint32_t max_measurement;
+    float calibration_distance[3]; ///< known distances A-B, A-C, B-C in meter
+    float ant_dly_temp_coeff; ///< antenna delay change in DWT time units per degree Celsius
+    uint8_t xtal_trim; ///< crystal trim, 0 -> value from OTP
 } device_settings_t;
 
 extern device_settings_t device_settings;
@@ -104,19 +120,69 @@ typedef enum {
     sensing_2,
     sensing_3,
     sensing_resp,
+    survey_token,
+    survey_done,
+    survey_report_request,
+    survey_report,
+    calibration_result,
+    ss_twr_1_poll,
+    all_twr_frame,
+    anchor_beacon,
+    slot_beacon,
+    slot_request,
+    slot_release,
+    ds_twr_4_report,
 } msg_id_t;
 
+/** 
+ * Header of all frames (7 byte). All frames are packed, they are sent
+ * as they are in memory. The sequence is the lower 16 bit of the 
+ * 32 bit session sequence, the receiver extends it (sit_sequence.h).
+*/
+typedef struct {
+    uint8_t id;         ///< msg_id_t
+    uint16_t sequence;
+    sit_addr_t source;
+    sit_addr_t dest;
+} __packed header_t;
+
 typedef struct {
-    msg_id_t id;
-    uint8_t sequence;
-    uint8_t source;
-    uint8_t dest;
-} header_t;
+    header_t header;
+    uint16_t crc;
+} __packed msg_simple_t;
+BUILD_ASSERT(sizeof(msg_simple_t) == sizeof(header_t) + 2);
+
+#ifndef CONFIG_SIT_SURVEY_MAX_ANCHORS
+#define CONFIG_SIT_SURVEY_MAX_ANCHORS 8
+#endif
 
 typedef struct {
     header_t header;
+    uint16_t distance_cm[CONFIG_SIT_SURVEY_MAX_ANCHORS]; ///< mean distance to anchor 100 + i, 0 if not measured
     uint16_t crc;
-} msg_simple_t;
+} __packed msg_survey_report_t;
+BUILD_ASSERT(sizeof(msg_survey_report_t) == sizeof(header_t) + 2 * CONFIG_SIT_SURVEY_MAX_ANCHORS + 2);
+
+#ifndef CONFIG_SIT_SLOTS_COUNT
+#define CONFIG_SIT_SLOTS_COUNT 8
+#endif
+
+typedef struct {
+    header_t header;
+    uint8_t slots;      ///< tag slots of the superframe
+    uint8_t slot_ms;    ///< length of a slot, the beacon slot is the first one
+    sit_addr_t owner[CONFIG_SIT_SLOTS_COUNT]; ///< tag of slot i, SIT_ADDR_BROADCAST if free
+    uint16_t crc;
+} __packed msg_slot_beacon_t;
+BUILD_ASSERT(sizeof(msg_slot_beacon_t) == sizeof(header_t) + 2 + 2 * CONFIG_SIT_SLOTS_COUNT + 2);
+
+typedef struct {
+    header_t header;
+    int16_t delay_a; ///< antenna delay error (tx + rx) of device A in DWT time units
+    int16_t delay_b; ///< antenna delay error (tx + rx) of device B in DWT time units
+    uint16_t crc;
+} __packed msg_calibration_result_t;
+BUILD_ASSERT(sizeof(msg_calibration_result_t) == sizeof(header_t) + 6);
 
 typedef struct {
     uint8_t nlos; // NLOS percentage
@@ -126,10 +192,11 @@ typedef struct {
 
 typedef struct {
     header_t header;
-    uint32_t poll_rx_ts;
-    uint32_t resp_tx_ts;
+    uint8_t poll_rx_ts[5]; ///< 40 bit timestamp, little endian
+    uint8_t resp_tx_ts[5]; ///< 40 bit timestamp, little endian
     uint16_t crc;
-} msg_ss_twr_final_t;
+} __packed msg_ss_twr_final_t;
+BUILD_ASSERT(sizeof(msg_ss_twr_final_t) == sizeof(header_t) + 12);
 
 typedef struct {
     header_t header;
@@ -137,7 +204,16 @@ typedef struct {
     uint32_t resp_rx_ts;
     uint32_t final_tx_ts;
     uint16_t crc;
-} msg_ds_twr_final_t;
+} __packed msg_ds_twr_final_t;
+BUILD_ASSERT(sizeof(msg_ds_twr_final_t) == sizeof(header_t) + 14);
+
+/** DS-TWR distance calculated at the responder, sent back to the initiator */
+typedef struct {
+    header_t header;
+    int32_t distance_mm;
+    uint16_t crc;
+} __packed msg_ds_twr_report_t;
+BUILD_ASSERT(sizeof(msg_ds_twr_report_t) == sizeof(header_t) + 6);
 
 typedef struct {
     header_t header;
@@ -145,7 +221,8 @@ typedef struct {
     uint32_t sensing_2_rx;
     uint32_t sensing_3_tx;
     uint16_t crc;
-} msg_sensing_3_t;
+} __packed msg_sensing_3_t;
+BUILD_ASSERT(sizeof(msg_sensing_3_t) == sizeof(header_t) + 14);
 
 typedef struct {
     header_t header;
@@ -153,12 +230,13 @@ typedef struct {
     uint32_t sensing_2_tx;
     uint32_t sensing_3_rx;
     uint16_t crc;
-} msg_sensing_info_t;
+} __packed msg_sensing_info_t;
+BUILD_ASSERT(sizeof(msg_sensing_info_t) == sizeof(header_t) + 14);
 
 typedef struct {
     char type[15];
     char state[15];
-    uint8_t responder;
+    sit_addr_t responder;
     uint32_t sequence;
     uint32_t measurements;
 } json_header_t;
@@ -219,6 +297,33 @@ typedef struct {
     json_td_data_t data;
 } json_simple_td_msg_t;
 
+typedef struct {
+    float x;
+    float y;
+    float z;
+    float quality; ///< RMS of the range residuals in meter
+    uint8_t anchors;
+    uint8_t iterations;
+} json_position_data_t;
+
+typedef struct {
+    json_simple_header_t header;
+    json_position_data_t data;
+} json_position_msg_t;
+
+typedef struct {
+    int16_t delay_a;
+    int16_t delay_b;
+    float std_a;
+    float std_b;
+    uint32_t rounds;
+} json_calibration_data_t;
+
+typedef struct {
+    json_simple_header_t header;
+    json_calibration_data_t data;
+} json_calibration_msg_t;
+
 extern dwt_config_t sit_device_config;
 
 /* Delay between frames, in UWB microseconds. */
@@ -240,6 +345,8 @@ extern dwt_config_t sit_device_config;
 #define DS_POLL_RX_TO_RESP_TX_DLY_UUS 1600
 #define DS_RESP_TX_TO_FINAL_RX_DLY_UUS 1200
 #define DS_FINAL_RX_TIMEOUT 1800
+/* Distance report after the final, sent immediately by the responder */
+#define DS_REPORT_RX_TIMEOUT_UUS 4000
 
 
 /**
@@ -249,13 +356,16 @@ extern dwt_config_t sit_device_config;
 #define UUS_TO_DWT_TIME 63898
 
 void set_device_state(char *comand);
-void set_device_id(uint8_t device_id);
+void set_device_id(sit_addr_t device_id);
 void set_device_type(char *type);
-void set_responder(uint8_t responder);
+void set_responder(sit_addr_t responder);
 void set_min_measurement(uint32_t measurement);
 void set_max_measurement(uint32_t measurement);
 void set_measurement_type(char *measurement_type);
 void set_rx_ant_dly(uint16_t dly);
 void set_tx_ant_dly(uint16_t dly);
+void set_calibration_distance(float distance_ab, float distance_ac, float distance_bc);
+void set_ant_dly_temp_coeff(float coeff);
+void set_xtal_trim(uint8_t trim);
 
 #endif // __SIT_CONFIG_H__
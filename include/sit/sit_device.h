@@ -133,3 +133,15 @@ void init_device_id(void);
  * @return  none
  */
 void get_device_id(char **deviceID);
+
+/********************************************************************************
+ * @brief Get the tag address of this device
+ * 
+ * The hardware id is folded into the tag address range (1..SIT_TAG_ADDR_MAX),
+ * so tags without an address from the setup do not share one address.
+ *
+ * @param  none
+ *
+ * @return  tag address
+ */
+uint16_t get_tag_address(void);
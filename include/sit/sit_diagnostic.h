@@ -37,9 +37,74 @@
 #include "sit_config.h"
 #include <stdint.h>
 
+#ifdef CONFIG_DW3000_SPI_ASYNC
+#include <zephyr/kernel.h>
+#endif
+
 
 void get_fp_pp_index(void);
 
 void get_diagnostic(diagnostic_info *diagnostic);
 
+/***************************************************************************
+ * Value of an 18 bit accumulator sample (3 bytes little endian).
+ *
+ * @return sign extended value
+ *
+****************************************************************************/
+int32_t accum_sample(const uint8_t *data);
+
+#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+/***************************************************************************
+ * Load the NLOS classifier weights (SIT_NLOS_FEATURES entries each).
+ *
+ * Until a model is loaded the classifier reproduces the 12 dB rule.
+ *
+ * @return None
+ *
+****************************************************************************/
+void set_nlos_model(const float *mean, const float *scale, const float *weight, float bias);
+
+/***************************************************************************
+ * Run the NLOS inference for the last frame read by get_diagnostic().
+ *
+ * get_diagnostic() only reads the CIR, so a reply can be scheduled first.
+ * Call before diagnostic->nlos is used, a second call is a no-op.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_diagnostic_classify(diagnostic_info *diagnostic);
+#endif
+
+#ifdef CONFIG_DW3000_SPI_ASYNC
+/***************************************************************************
+ * Start an accumulator read, the data transfer runs with EasyDMA.
+ *
+ * Same parameters as dwt_readaccdata. The buffer is valid after
+ * wait_accumulator returned 0, the CPU can do other work in between.
+ *
+ * @return None
+ *
+****************************************************************************/
+void read_accumulator_async(uint8_t *buffer, uint16_t length, uint16_t offset, struct k_poll_signal *signal);
+
+/***************************************************************************
+ * Wait for the end of an accumulator read.
+ *
+ * @return 0 on success, negative errno otherwise
+ *
+****************************************************************************/
+int wait_accumulator(struct k_poll_signal *signal);
+
+/***************************************************************************
+ * Compare blocking and asynchronous 1 KB accumulator reads and log
+ * the transfer time and the CPU busy time.
+ *
+ * @return None
+ *
+****************************************************************************/
+void spi_read_benchmark(void);
+#endif
+
 #endif // __SIT_DIAGNOSTIC_H__
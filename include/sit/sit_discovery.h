@@ -0,0 +1,104 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_discovery.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the anchor discovery.
+ *
+ * Anchors which are not polled for CONFIG_SIT_DISCOVERY_BEACON_MS send a
+ * beacon (anchor_beacon, broadcast). The initiator listens for beacons
+ * CONFIG_SIT_DISCOVERY_LISTEN_MS after every ranging cycle and polls the
+ * anchors of its responder table (sit_responder_table.h) instead of the
+ * fixed ids 100 .. device_settings.responder.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_DISCOVERY_H__
+#define __SIT_DISCOVERY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sit_responder_table.h"
+
+/***************************************************************************
+ * Remove all anchors from the responder table.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_discovery_reset(void);
+
+/***************************************************************************
+ * Responder: RX timeout in UUS, after this time without a poll a beacon
+ * is sent.
+ *
+****************************************************************************/
+uint32_t sit_discovery_rx_timeout(void);
+
+/***************************************************************************
+ * Responder: send a beacon if no poll is received for a beacon period.
+ *
+ * @param polled    -> a poll for this anchor was received
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_discovery_responder(bool polled);
+
+/***************************************************************************
+ * Initiator: remove dead anchors and get the addresses of all others.
+ *
+ * @param addresses -> array with SIT_RESPONDER_TABLE_SIZE entries
+ *
+ * @return number of anchors
+ *
+****************************************************************************/
+uint16_t sit_discovery_responders(uint16_t *addresses);
+
+/***************************************************************************
+ * Initiator: result of a poll.
+ *
+ * @param distance      -> distance in meter, negative if not available
+ * @param clock_offset  -> clock offset ratio to the anchor
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_discovery_update(uint16_t address, bool success, double distance, double clock_offset);
+
+/***************************************************************************
+ * Initiator: listen for beacons for CONFIG_SIT_DISCOVERY_LISTEN_MS.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_discovery_listen(void);
+
+/***************************************************************************
+ * Get the responder table (read only).
+ *
+****************************************************************************/
+const sit_responder_table_t *sit_discovery_table(void);
+
+#endif // __SIT_DISCOVERY_H__
@@ -55,6 +55,41 @@ void sit_receive_now(uint16_t preamble_detction_timeout, uint32_t rx_timeout);
 ****************************************************************************/
 void sit_start_poll(uint8_t* msg_data, uint16_t msg_size);
 
+/***************************************************************************
+ * Start ranging with a poll msg, with CONFIG_SIT_CCA the poll is sent 
+ * only on a clear channel (CCA with random backoff, sit_backoff.h). The 
+ * CCA listens for the preamble detection timeout set for the response.
+ *
+ * @param uint8_t* msg_data ->  pointer to the data you like to send with
+ *                              the poll msg
+ * @param uint16_t msg_size ->  length of the data you like to send 
+ *
+ * @return bool true  -> if the poll is sent
+ *         bool false -> if the channel was busy for all backoffs
+ *
+****************************************************************************/
+bool sit_start_poll_cca(uint8_t* msg_data, uint16_t msg_size);
+
+#ifdef CONFIG_SIT_CCA
+#include "sit_backoff.h"
+
+/***************************************************************************
+ * Result of a poll sent with sit_start_poll_cca(), a poll without a 
+ * response is counted in no_response (collision, responder out of range
+ * or busy).
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_cca_result(bool response);
+
+/***************************************************************************
+ * Counters of the channel access.
+ *
+****************************************************************************/
+const sit_backoff_stats_t *sit_cca_stats();
+#endif
+
 /***************************************************************************
  * Send a 
  *
@@ -69,17 +104,29 @@ void sit_start_poll(uint8_t* msg_data, uint16_t msg_size);
 ****************************************************************************/
 bool sit_send_at(uint8_t* msg_data, uint16_t size, uint32_t tx_time);
 bool sit_send_at_with_response(uint8_t* msg_data, uint16_t size, uint32_t tx_time);
+
 /***************************************************************************
- * Start ranging with a poll msg 
+ * Send a msg immediately and wait until it is send
  *
- * @param uint8_t* msg_data ->  pointer to the data you like to send with
- *                              the poll msg
- * @param uint32_t msg_size ->  length of the data you like to send 
+ * @param uint8_t* msg_data ->  pointer to the data you like to send
+ * @param uint16_t size     ->  length of the data you like to send 
  *
- * @return None
+ * @return bool true  -> if the msg is send
+ *         bool false -> if the transmission could not be started
+ *
+****************************************************************************/
+bool sit_send_now(uint8_t* msg_data, uint16_t size);
+/***************************************************************************
+ * Enable the receiver at the time set with dwt_setdelayedtrxtime()
+ *
+ * @param uint32_t timeout  ->  rx timeout in uus after the receiver is 
+ *                              enabled, 0 disables the timeout
+ *
+ * @return bool true  -> if the receiver is enabled at the delayed time
+ *         bool false -> if the delayed time has already passed
  *
 ****************************************************************************/
-void sit_receive_at(uint32_t timeout);
+bool sit_receive_at(uint32_t timeout);
 
 bool sit_check_msg_id(msg_id_t id, msg_simple_t * message);
 
@@ -87,10 +134,29 @@ bool sit_check_final_msg_id(msg_id_t id, msg_ss_twr_final_t* message);
 
 bool sit_check_ds_final_msg_id(msg_id_t id, msg_ds_twr_final_t* message);
 
+bool sit_check_ds_report_msg_id(msg_id_t id, msg_ds_twr_report_t* message);
+
 bool sit_check_sensing_3_msg_id(msg_id_t id, msg_sensing_3_t * message);
 
 bool sit_check_sensing_info_msg_id(msg_id_t id, msg_sensing_info_t * message);
 
+bool sit_check_survey_report_msg_id(msg_id_t id, msg_survey_report_t * message);
+
+bool sit_check_calibration_result_msg_id(msg_id_t id, msg_calibration_result_t * message);
+
+/***************************************************************************
+ * Receive a msg of any type, for protocols where the next msg is not known
+ *
+ * @param uint8_t* data        ->  buffer for the received frame
+ * @param uint16_t max_length  ->  size of the buffer
+ *
+ * @return bool true  -> if a frame with a header is received, the header
+ *                       is at the start of data
+ *         bool false -> on timeout, error or a frame which does not fit
+ *
+****************************************************************************/
+bool sit_check_any_msg(uint8_t* data, uint16_t max_length);
+
 void sit_set_rx_tx_delay_and_rx_timeout(uint32_t delay_us,uint16_t timeout);
 void sit_set_rx_after_tx_delay(uint32_t delay_us);
 void sit_set_rx_timeout(uint16_t timeout);
@@ -0,0 +1,72 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_mds.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the anchor survey solver.
+ *
+ * Relative anchor positions from an anchor-to-anchor distance matrix:
+ * classical multidimensional scaling (MDS) for the start values and a
+ * refinement which re-solves every anchor against all others with the
+ * Gauss-Newton solver of the position engine.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_MDS_H__
+#define __SIT_MDS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sit_position.h"
+
+#ifndef CONFIG_SIT_SURVEY_MAX_ANCHORS
+#define CONFIG_SIT_SURVEY_MAX_ANCHORS 8
+#endif
+
+#define SIT_MDS_MAX_ANCHORS CONFIG_SIT_SURVEY_MAX_ANCHORS
+
+/***************************************************************************
+ * Solve relative anchor positions from a distance matrix.
+ *
+ * The result is expressed in a local frame: anchor 0 is the origin,
+ * anchor 1 lies on the positive x-axis, anchor 2 has y >= 0 (and in 3D
+ * anchor 3 has z >= 0).
+ *
+ * @param distances -> count x count matrix (row major) in meter, entries
+ *                     <= 0 are treated as not measured. d[i][j] and
+ *                     d[j][i] are averaged.
+ * @param count     -> number of anchors (3..SIT_MDS_MAX_ANCHORS)
+ * @param solve_3d  -> solve x/y/z, otherwise z = 0
+ * @param positions -> output array with count entries
+ *
+ * @return RMS of the distance residuals in meter, negative on failure
+ *
+****************************************************************************/
+float sit_mds_solve(
+    const float *distances,
+    uint8_t count,
+    bool solve_3d,
+    sit_vec3_t *positions
+);
+
+#endif // __SIT_MDS_H__
@@ -0,0 +1,104 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_nlos.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the NLOS feature extractor and classifier.
+ *
+ * Features from the diagnostic registers and a short CIR window around the
+ * first path, classified by a fixed-point logistic regression whose weights
+ * are loaded at runtime. All values are Q8 (value * 256) in int32.
+ *
+ * A host benchmark is in lib/sit/sim/sit_nlos_bench.c.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_NLOS_H__
+#define __SIT_NLOS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIT_NLOS_Q          8
+#define SIT_NLOS_ONE        (1 << SIT_NLOS_Q)
+#define SIT_NLOS_PROB_ONE   32768 // probability in Q15
+
+typedef enum {
+    nlos_fp_pp,         ///< peak path index - first path index in taps
+    nlos_rise_time,     ///< taps from 10 % to 90 % of the peak amplitude
+    nlos_kurtosis,      ///< kurtosis of the CIR amplitudes
+    nlos_rsl_fpl,       ///< received signal level - first path level in dB
+    nlos_dgc,           ///< DGC decision (0..7)
+    SIT_NLOS_FEATURES
+} sit_nlos_feature_t;
+
+typedef struct {
+    int32_t mean[SIT_NLOS_FEATURES];    ///< subtracted before scaling
+    int32_t scale[SIT_NLOS_FEATURES];   ///< 1 / standard deviation
+    int32_t weight[SIT_NLOS_FEATURES];
+    int32_t bias;
+} sit_nlos_model_t;
+
+/***************************************************************************
+ * Default model: the former rule, P(NLOS) = 0.5 at RSL - FPL = 12 dB.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_nlos_model_default(sit_nlos_model_t *model);
+
+/***************************************************************************
+ * Convert a model trained offline (float) into the fixed-point model.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_nlos_model_from_float(
+    sit_nlos_model_t *model,
+    const float *mean,
+    const float *scale,
+    const float *weight,
+    float bias
+);
+
+/***************************************************************************
+ * Rise time and kurtosis from a CIR window.
+ *
+ * @param iq        -> int16 I/Q interleaved, taps entries each
+ * @param taps      -> number of taps in the window (max 1016)
+ * @param features  -> nlos_rise_time and nlos_kurtosis are set
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_nlos_cir_features(const int16_t *iq, uint16_t taps, int32_t *features);
+
+/***************************************************************************
+ * NLOS probability of a frame.
+ *
+ * @return probability in Q15 (0..SIT_NLOS_PROB_ONE)
+ *
+****************************************************************************/
+uint16_t sit_nlos_probability(const sit_nlos_model_t *model, const int32_t *features);
+
+#endif // __SIT_NLOS_H__
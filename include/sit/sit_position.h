@@ -0,0 +1,204 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_position.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the on-device position engine.
+ *
+ * The position engine stores the anchor coordinates from the setup message
+ * and the latest distance per responder and solves the tag position with an
+ * iterative Gauss-Newton least-squares in single precision.
+ *
+ * A host test of the NLOS rejection is in lib/sit/sim/sit_position_ransac_test.c.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_POSITION_H__
+#define __SIT_POSITION_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_POSITION_MAX_ANCHORS
+#define CONFIG_SIT_POSITION_MAX_ANCHORS 8
+#endif
+
+#ifndef CONFIG_SIT_POSITION_MAX_ITERATIONS
+#define CONFIG_SIT_POSITION_MAX_ITERATIONS 10
+#endif
+
+#ifndef CONFIG_SIT_POSITION_MAX_AGE
+#define CONFIG_SIT_POSITION_MAX_AGE 2
+#endif
+
+#ifndef CONFIG_SIT_POSITION_RANSAC_ITERATIONS
+#define CONFIG_SIT_POSITION_RANSAC_ITERATIONS 16
+#endif
+
+#ifndef CONFIG_SIT_POSITION_RANSAC_THRESHOLD_CM
+#define CONFIG_SIT_POSITION_RANSAC_THRESHOLD_CM 30
+#endif
+
+#define SIT_POSITION_MAX_ANCHORS CONFIG_SIT_POSITION_MAX_ANCHORS
+
+typedef struct {
+    float x;
+    float y;
+    float z;
+} sit_vec3_t;
+
+typedef struct {
+    float x;
+    float y;
+    float z;
+    float quality;      ///< RMS of the range residuals in meter
+    uint8_t anchors;    ///< number of anchors used for the fix
+    uint8_t iterations; ///< Gauss-Newton iterations until convergence
+    uint8_t hypotheses; ///< RANSAC hypotheses tested, 0 without RANSAC
+    bool valid;
+} sit_position_t;
+
+/***************************************************************************
+ * Solve a position from anchor coordinates and measured distances.
+ *
+ * @param anchors   -> array with the anchor coordinates in meter
+ * @param distances -> array with the measured distance to each anchor
+ * @param count     -> number of anchors in both arrays
+ * @param solve_3d  -> true solve x/y/z, false keep z from position->z
+ * @param position  -> in: start value (if position->valid), out: the fix
+ *
+ * @return true  -> if the solver converged to a valid position
+ *         false -> if there are not enough anchors or the geometry is
+ *                  singular
+ *
+****************************************************************************/
+bool sit_position_solve(
+    const sit_vec3_t *anchors,
+    const float *distances,
+    uint8_t count,
+    bool solve_3d,
+    sit_position_t *position
+);
+
+/***************************************************************************
+ * Robust position fix against NLOS anchors.
+ *
+ * RANSAC with a fixed number of iterations (CONFIG_SIT_POSITION_RANSAC_ITERATIONS):
+ * every iteration solves a minimal subset (3 anchors in 2D, 4 in 3D) drawn
+ * with a probability proportional to the anchor prior, counts the anchors
+ * with a residual below CONFIG_SIT_POSITION_RANSAC_THRESHOLD_CM and keeps
+ * the largest consensus set. The final fix is a least-squares over the
+ * consensus set. The worst-case CPU time per fix is therefore
+ * (iterations + 1) Gauss-Newton solves.
+ *
+ * @param prior     -> probability (0..1) that the anchor is line of sight,
+ *                     NULL for uniform sampling
+ *
+ * @return true if a valid position is available
+ *
+****************************************************************************/
+bool sit_position_solve_robust(
+    const sit_vec3_t *anchors,
+    const float *distances,
+    const float *prior,
+    uint8_t count,
+    bool solve_3d,
+    sit_position_t *position
+);
+
+/***************************************************************************
+ * Line of sight prior of a distance from the diagnostic of its frame.
+ *
+ * @param nlos  -> NLOS percentage (0..100)
+ * @param rssi  -> received signal level in dBm
+ * @param fpi   -> first path level in dBm
+ *
+ * @return prior in the range 0.05..1
+ *
+****************************************************************************/
+float sit_position_prior(uint8_t nlos, float rssi, float fpi);
+
+/***************************************************************************
+ * Set the coordinates of an anchor (responder 100 + index).
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_position_set_anchor(uint8_t index, float x, float y, float z);
+
+/***************************************************************************
+ * Remove all anchors and distances from the position engine.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_position_clear(void);
+
+/***************************************************************************
+ * Store the latest distance to an anchor (responder 100 + index).
+ *
+ * @param index     -> index of the anchor
+ * @param distance  -> measured distance in meter
+ * @param sequence  -> ranging cycle in which the distance was measured
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_position_set_distance(uint8_t index, float distance, uint32_t sequence);
+
+/***************************************************************************
+ * Store the line of sight prior of the latest distance to an anchor.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_position_set_prior(uint8_t index, float prior);
+
+/***************************************************************************
+ * Solve the position from all anchors which have a distance not older than
+ * CONFIG_SIT_POSITION_MAX_AGE ranging cycles.
+ *
+ * @param sequence  -> current ranging cycle
+ * @param position  -> output position
+ *
+ * @return true if a valid position is available
+ *
+****************************************************************************/
+bool sit_position_fix(uint32_t sequence, sit_position_t *position);
+
+/***************************************************************************
+ * Get the coordinates of an anchor.
+ *
+ * @return true if coordinates for this anchor are set
+ *
+****************************************************************************/
+bool sit_position_get_anchor(uint8_t index, sit_vec3_t *anchor);
+
+/***************************************************************************
+ * Get the last valid position.
+ *
+ * @return true if the last fix was valid
+ *
+****************************************************************************/
+bool sit_position_last(sit_position_t *position);
+
+#endif // __SIT_POSITION_H__
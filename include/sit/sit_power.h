@@ -0,0 +1,89 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_power.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the DW3000 deep sleep duty cycle and energy model.
+ *
+ * Between two ranging cycles the DW3000 is put into deep sleep, the 
+ * configuration is kept in the AON memory. It is woken up 
+ * CONFIG_SIT_POWER_WAKEUP_US before the next cycle, so the cycle period
+ * stays constant.
+ *
+ * The energy model integrates the time in every state with the currents
+ * from Kconfig (in uA) and reports the average current of the DW3000.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_POWER_H__
+#define __SIT_POWER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Air time of one ranging frame (PLEN 128, 6.8 Mbps, ~20 byte payload) */
+#define SIT_POWER_FRAME_US 180
+
+typedef struct {
+    uint64_t sleep_us;  ///< time in deep sleep
+    uint64_t awake_us;  ///< time awake (idle, rx or tx)
+    uint32_t tx_frames; ///< number of transmitted frames
+    uint32_t cycles;    ///< number of sleep cycles
+    float average_ua;   ///< average current of the DW3000 in uA
+} sit_power_stats_t;
+
+/***************************************************************************
+ * Configure the sleep mode of the DW3000, call after sit_init()
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_power_init(void);
+
+/***************************************************************************
+ * Sleep until the next ranging cycle and wake up the DW3000 in time.
+ *
+ * @param int64_t cycle_start -> uptime in ms when the current cycle started
+ * @param uint32_t period_ms  -> ranging period in ms
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_power_duty_cycle(int64_t cycle_start, uint32_t period_ms);
+
+/***************************************************************************
+ * Count a transmitted frame for the energy model
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_power_count_tx(void);
+
+/***************************************************************************
+ * Get the statistic and the average current from the energy model
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_power_get_stats(sit_power_stats_t *stats);
+
+#endif // __SIT_POWER_H__
@@ -0,0 +1,63 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_range_bias.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the range bias correction.
+ *
+ * The DW3000 reports a distance bias which depends on the received signal
+ * level. The correction tables per channel and PRF are generated at build
+ * time by scripts/gen_range_bias.py, the same script evaluates a table
+ * against recorded datasets on the host.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_RANGE_BIAS_H__
+#define __SIT_RANGE_BIAS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/***************************************************************************
+ * Range bias (measured - true distance) for a received signal level.
+ *
+ * Outside the table range the first or last entry is used.
+ *
+ * @param channel   -> UWB channel (5 or 9)
+ * @param prf_64    -> true for 64 MHz PRF, false for 16 MHz
+ * @param rsl_q8    -> received signal level in dBm, Q8
+ *
+ * @return bias in mm
+ *
+****************************************************************************/
+int32_t sit_range_bias_mm(uint8_t channel, bool prf_64, int32_t rsl_q8);
+
+/***************************************************************************
+ * Correct a distance by the range bias.
+ *
+ * @return corrected distance in mm
+ *
+****************************************************************************/
+int32_t sit_range_bias_correct_mm(int32_t distance_mm, uint8_t channel, bool prf_64, int32_t rsl_q8);
+
+#endif // __SIT_RANGE_BIAS_H__
@@ -0,0 +1,118 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_responder_table.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the responder table of the anchor discovery.
+ *
+ * Fixed capacity table of the known anchors in a struct-of-arrays layout:
+ * the poll loop and the aging only touch the arrays they need, and the
+ * entries are kept dense (a removed entry is replaced by the last one).
+ * An entry is created by a beacon and refreshed by every beacon and every
+ * successful range, it is removed when it is not seen for the timeout.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_RESPONDER_TABLE_H__
+#define __SIT_RESPONDER_TABLE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_DISCOVERY_MAX_ANCHORS
+#define CONFIG_SIT_DISCOVERY_MAX_ANCHORS 64
+#endif
+
+#define SIT_RESPONDER_TABLE_SIZE CONFIG_SIT_DISCOVERY_MAX_ANCHORS
+
+/** Link quality of a new entry (0..255) */
+#define SIT_RESPONDER_QUALITY_START 128
+/** Distance filter: new = old + (sample - old) / 2^SHIFT */
+#define SIT_RESPONDER_DISTANCE_SHIFT 2
+/** Link quality filter: new = old + (target - old) / 2^SHIFT */
+#define SIT_RESPONDER_QUALITY_SHIFT 3
+
+typedef struct {
+    uint16_t count;
+    uint16_t address[SIT_RESPONDER_TABLE_SIZE];      ///< device address of the anchor
+    uint32_t last_seen[SIT_RESPONDER_TABLE_SIZE];    ///< uptime in ms of the last beacon or range
+    uint8_t link_quality[SIT_RESPONDER_TABLE_SIZE];  ///< 0 (no response) .. 255 (every poll answered)
+    int32_t distance_mm[SIT_RESPONDER_TABLE_SIZE];   ///< filtered distance, INT32_MIN if not measured
+    int16_t clock_offset[SIT_RESPONDER_TABLE_SIZE];  ///< clock offset to the anchor in 0.01 ppm
+} sit_responder_table_t;
+
+/***************************************************************************
+ * Remove all entries.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_responder_table_reset(sit_responder_table_t *table);
+
+/***************************************************************************
+ * Index of an anchor.
+ *
+ * @return index, -1 if the anchor is not in the table
+ *
+****************************************************************************/
+int16_t sit_responder_table_find(const sit_responder_table_t *table, uint16_t address);
+
+/***************************************************************************
+ * An anchor is seen (beacon), it is added if it is not in the table.
+ *
+ * @param now_ms    -> uptime in ms
+ *
+ * @return index, -1 if the table is full
+ *
+****************************************************************************/
+int16_t sit_responder_table_seen(sit_responder_table_t *table, uint16_t address, uint32_t now_ms);
+
+/***************************************************************************
+ * Result of a poll to the anchor at index.
+ *
+ * @param success       -> the anchor answered
+ * @param distance_mm   -> measured distance, INT32_MIN if not available
+ *                         (DS-TWR: the distance is calculated at the anchor)
+ * @param clock_offset  -> clock offset to the anchor in 0.01 ppm
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_responder_table_update(
+    sit_responder_table_t *table,
+    uint16_t index,
+    bool success,
+    int32_t distance_mm,
+    int16_t clock_offset,
+    uint32_t now_ms
+);
+
+/***************************************************************************
+ * Remove all anchors not seen for timeout_ms.
+ *
+ * @return number of removed anchors
+ *
+****************************************************************************/
+uint16_t sit_responder_table_age(sit_responder_table_t *table, uint32_t now_ms, uint32_t timeout_ms);
+
+#endif // __SIT_RESPONDER_TABLE_H__
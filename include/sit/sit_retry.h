@@ -0,0 +1,96 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_retry.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the in-cycle retry policy of the initiator.
+ *
+ * A failed exchange is repeated at once if the remaining time of the slot
+ * (or of the retry budget of the cycle) still covers the retry and one
+ * exchange for every responder which is not polled yet, so a retry never
+ * costs a later responder its range. The statistic counts per responder
+ * the polled cycles, the cycles with a range, the retries and the ranges
+ * recovered by a retry.
+ *
+ * A host simulation of the policy is in lib/sit/sim/sit_retry_sim.c.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_RETRY_H__
+#define __SIT_RETRY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_RETRY_MAX
+#define CONFIG_SIT_RETRY_MAX 2
+#endif
+
+#ifndef CONFIG_SIT_RETRY_MAX_RESPONDERS
+#define CONFIG_SIT_RETRY_MAX_RESPONDERS 16
+#endif
+
+#define SIT_RETRY_MAX_RESPONDERS CONFIG_SIT_RETRY_MAX_RESPONDERS
+
+typedef struct {
+    uint16_t count;
+    uint16_t address[SIT_RETRY_MAX_RESPONDERS];
+    uint32_t cycles[SIT_RETRY_MAX_RESPONDERS];      ///< cycles in which the responder was polled
+    uint32_t ranges[SIT_RETRY_MAX_RESPONDERS];      ///< cycles with a successful exchange
+    uint32_t retries[SIT_RETRY_MAX_RESPONDERS];     ///< repeated polls
+    uint32_t recovered[SIT_RETRY_MAX_RESPONDERS];   ///< ranges after at least one retry
+} sit_retry_stats_t;
+
+/***************************************************************************
+ * Remove all responders from the statistic.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_retry_reset(sit_retry_stats_t *stats);
+
+/***************************************************************************
+ * Decide if a failed exchange is repeated.
+ *
+ * @param attempts          -> exchanges with this responder in this cycle
+ * @param exchange_us       -> duration of the failed exchange
+ * @param remaining_us      -> time until the end of the slot or budget
+ * @param responders_left   -> responders not polled yet in this cycle
+ *
+ * @return true if the poll is repeated
+ *
+****************************************************************************/
+bool sit_retry_allowed(uint8_t attempts, uint32_t exchange_us, uint32_t remaining_us, uint16_t responders_left);
+
+/***************************************************************************
+ * Result of a responder in a cycle.
+ *
+ * @param attempts  -> exchanges with the responder in this cycle
+ * @param success   -> the last exchange was successful
+ *
+ * @return index of the responder in the statistic, -1 if it is full
+ *
+****************************************************************************/
+int16_t sit_retry_record(sit_retry_stats_t *stats, uint16_t address, uint8_t attempts, bool success);
+
+#endif // __SIT_RETRY_H__
@@ -0,0 +1,106 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_rx_window.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the scheduled RX windows of a responder.
+ *
+ * A responder is polled once per ranging cycle. The poll interval is 
+ * estimated from the rx timestamps of the polls (exponential average as
+ * for the TCP round trip time), the guard interval around the expected
+ * poll follows the mean deviation of the interval, so it adapts to the
+ * clock drift and the jitter of the initiator. All times are in DWT time
+ * units, timestamps are 40 bit.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_RX_WINDOW_H__
+#define __SIT_RX_WINDOW_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_RX_WINDOW_MIN_GUARD_US
+#define CONFIG_SIT_RX_WINDOW_MIN_GUARD_US 300
+#endif
+
+#ifndef CONFIG_SIT_RX_WINDOW_MAX_MISSES
+#define CONFIG_SIT_RX_WINDOW_MAX_MISSES 3
+#endif
+
+#define SIT_RX_WINDOW_TIMESTAMP_MASK 0xFFFFFFFFFFULL
+
+typedef struct {
+    uint64_t last_rx;   ///< rx timestamp of the last poll
+    double interval;    ///< estimated poll interval
+    double deviation;   ///< mean deviation of the poll interval
+    uint8_t misses;     ///< windows without a poll since the last poll
+    bool locked;        ///< last_rx is valid, windows can be used
+} sit_rx_window_t;
+
+/***************************************************************************
+ * Reset the schedule, the next poll must be received with the receiver 
+ * continuously on.
+ *
+ * @param interval -> expected poll interval as start value
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_rx_window_reset(sit_rx_window_t *window, double interval);
+
+/***************************************************************************
+ * Update the schedule with the rx timestamp of a received poll
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_rx_window_update(sit_rx_window_t *window, uint64_t rx_ts);
+
+/***************************************************************************
+ * Mark a window without a poll. After CONFIG_SIT_RX_WINDOW_MAX_MISSES the
+ * schedule is unlocked.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_rx_window_miss(sit_rx_window_t *window);
+
+/***************************************************************************
+ * Get the next RX window
+ *
+ * @param start  -> 40 bit timestamp when the receiver has to be enabled
+ * @param length -> length of the window
+ *
+ * @return true  -> if the schedule is locked
+ *         false -> if the receiver has to stay on
+ *
+****************************************************************************/
+bool sit_rx_window_next(const sit_rx_window_t *window, uint64_t *start, double *length);
+
+/***************************************************************************
+ * Guard interval before and after the expected poll
+ *
+****************************************************************************/
+double sit_rx_window_guard(const sit_rx_window_t *window);
+
+#endif // __SIT_RX_WINDOW_H__
@@ -0,0 +1,89 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_sequence.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the sequence number extension.
+ *
+ * The header carries the lower 16 bit of the 32 bit session sequence. The
+ * receiver extends it to 32 bit with the value closest to the highest
+ * sequence received so far, which is unambiguous as long as less than
+ * 2^15 frames are lost in a row (11 minutes at 50 Hz). A window of the
+ * last 32 sequences detects late (reordered) and duplicated frames.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_SEQUENCE_H__
+#define __SIT_SEQUENCE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIT_SEQUENCE_WINDOW 32
+
+typedef enum {
+    sit_sequence_next,      ///< newer than all received sequences
+    sit_sequence_late,      ///< older, missing until now (reordered)
+    sit_sequence_duplicate, ///< already received
+    sit_sequence_restart,   ///< older than the window, new session from here
+} sit_sequence_status_t;
+
+typedef struct {
+    uint32_t highest;       ///< highest extended sequence
+    uint32_t window;        ///< bit i: highest - i received
+    uint32_t received;
+    uint32_t lost;          ///< sequences missing at the moment
+    uint32_t reordered;
+    uint32_t duplicates;
+    bool started;
+} sit_sequence_t;
+
+/***************************************************************************
+ * Extend a 16 bit sequence to the 32 bit value closest to a reference.
+ *
+ * @return extended sequence
+ *
+****************************************************************************/
+uint32_t sit_sequence_extend(uint32_t reference, uint16_t sequence);
+
+/***************************************************************************
+ * Reset the statistic, the next sequence starts a new session.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_sequence_reset(sit_sequence_t *tracker);
+
+/***************************************************************************
+ * Received a frame with a 16 bit sequence. A sequence further behind than
+ * the window (e.g. the sender restarted) starts a new session with this
+ * sequence, the received, lost, reordered and duplicate counters are kept.
+ *
+ * @param extended  -> output, extended sequence
+ *
+ * @return classification of the frame
+ *
+****************************************************************************/
+sit_sequence_status_t sit_sequence_update(sit_sequence_t *tracker, uint16_t sequence, uint32_t *extended);
+
+#endif // __SIT_SEQUENCE_H__
@@ -0,0 +1,71 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_settings.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the persistent settings store.
+ *
+ * The device settings (device id, device type, responder count, 
+ * measurement type, antenna delays and anchor coordinates) are stored as
+ * one versioned record with the Zephyr settings subsystem (NVS backend).
+ * Every setter schedules a save, saves within 
+ * CONFIG_SIT_SETTINGS_SAVE_DELAY_MS are coalesced into one flash write.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_SETTINGS_H__
+#define __SIT_SETTINGS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Increase on every change of the record layout, old records are ignored */
+#define SIT_SETTINGS_VERSION 5
+
+/***************************************************************************
+ * Register the settings handler and restore the stored record into 
+ * device_settings. Call before sit_init(), the antenna delays are applied
+ * by sit_init().
+ *
+ * @return 0 on success, negative error code of the settings subsystem
+ *
+****************************************************************************/
+int sit_settings_init(void);
+
+/***************************************************************************
+ * Schedule a save of the current device settings.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_settings_save(void);
+
+/***************************************************************************
+ * Check if the device can range without a phone: a record was restored 
+ * and the device is a responder.
+ *
+ * @return true if ranging should start without a BLE connection
+ *
+****************************************************************************/
+bool sit_settings_autostart(void);
+
+#endif // __SIT_SETTINGS_H__
@@ -0,0 +1,123 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_slot_table.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the slot table of the superframe coordinator.
+ *
+ * Every tag slot of the superframe has an owner (tag address) and an idle
+ * counter: the coordinator counts the superframes in which it did not hear
+ * the owner and revokes the slot after a limit. A tag gets the same slot
+ * again if it requests while it still owns one.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_SLOT_TABLE_H__
+#define __SIT_SLOT_TABLE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_SLOTS_COUNT
+#define CONFIG_SIT_SLOTS_COUNT 8
+#endif
+
+#define SIT_SLOT_TABLE_SIZE CONFIG_SIT_SLOTS_COUNT
+#define SIT_SLOT_FREE 0xFFFF
+
+typedef struct {
+    uint8_t slots;                          ///< tag slots in use of SIT_SLOT_TABLE_SIZE
+    uint16_t owner[SIT_SLOT_TABLE_SIZE];    ///< tag address, SIT_SLOT_FREE if not granted
+    uint16_t idle[SIT_SLOT_TABLE_SIZE];     ///< superframes without a frame of the owner
+} sit_slot_table_t;
+
+/***************************************************************************
+ * Free all slots.
+ *
+ * @param slots -> tag slots per superframe (1..SIT_SLOT_TABLE_SIZE)
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slot_table_init(sit_slot_table_t *table, uint8_t slots);
+
+/***************************************************************************
+ * Slot of a tag.
+ *
+ * @return slot index, -1 if the tag has no slot
+ *
+****************************************************************************/
+int16_t sit_slot_table_find(const sit_slot_table_t *table, uint16_t tag);
+
+/***************************************************************************
+ * Grant a slot to a tag, the first free one if it has none.
+ *
+ * @return slot index, -1 if all slots are granted
+ *
+****************************************************************************/
+int16_t sit_slot_table_grant(sit_slot_table_t *table, uint16_t tag);
+
+/***************************************************************************
+ * Release the slot of a tag.
+ *
+ * @return true if the tag had a slot
+ *
+****************************************************************************/
+bool sit_slot_table_release(sit_slot_table_t *table, uint16_t tag);
+
+/***************************************************************************
+ * A frame of the tag was received, reset its idle counter.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slot_table_seen(sit_slot_table_t *table, uint16_t tag);
+
+/***************************************************************************
+ * End of a superframe: count the idle superframes and revoke the slots
+ * with more than max_idle.
+ *
+ * @return number of revoked slots
+ *
+****************************************************************************/
+uint8_t sit_slot_table_age(sit_slot_table_t *table, uint16_t max_idle);
+
+/***************************************************************************
+ * Number of granted slots.
+ *
+****************************************************************************/
+uint8_t sit_slot_table_used(const sit_slot_table_t *table);
+
+/***************************************************************************
+ * Slot at a time in the superframe. Slot 0 of the superframe holds the
+ * beacon and the slot requests, tag slot i is superframe slot i + 1.
+ *
+ * @param offset_ms -> time since the beacon
+ * @param slot_ms   -> length of a slot
+ *
+ * @return tag slot index, -1 in the beacon slot or after the last slot
+ *
+****************************************************************************/
+int16_t sit_slot_table_slot_at(const sit_slot_table_t *table, uint32_t offset_ms, uint16_t slot_ms);
+
+#endif // __SIT_SLOT_TABLE_H__
@@ -0,0 +1,121 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_slots.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the multi-tag superframe.
+ *
+ * Anchor 100 is the coordinator: it broadcasts a beacon (slot_beacon) at
+ * the start of every superframe with the owner of every tag slot. A tag
+ * without a slot sends a slot_request to the coordinator in the beacon
+ * slot after a random delay, the grant is the owner entry in the next
+ * beacon. A tag releases its slot when the measurement stops, the
+ * coordinator revokes the slot of a tag it did not hear for
+ * CONFIG_SIT_SLOTS_REVOKE_SUPERFRAMES. Every tag ranges only in its own
+ * slot, so the exchanges of different tags do not overlap.
+ *
+ * Superframe: | beacon + requests | tag slot 0 | ... | tag slot N-1 |
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_SLOTS_H__
+#define __SIT_SLOTS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sit_config.h"
+#include "sit_slot_table.h"
+
+/** Device id of the anchor which sends the beacons and grants the slots */
+#define SIT_SLOTS_COORDINATOR_ID 100
+
+/***************************************************************************
+ * Reset the slot table (coordinator) or the slot of the tag.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slots_reset(void);
+
+/***************************************************************************
+ * Coordinator: RX timeout in UUS which ends before the next beacon.
+ *
+ * @param timeout   -> RX timeout of the responder, 0 for none
+ *
+ * @return timeout, the given one if the device is not the coordinator
+ *
+****************************************************************************/
+uint32_t sit_slots_rx_timeout(uint32_t timeout);
+
+/***************************************************************************
+ * Coordinator: a frame was received in the responder loop (slot requests,
+ * slot releases and polls of the tags).
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slots_frame(const header_t *header);
+
+/***************************************************************************
+ * Coordinator: send the beacon if the next superframe starts.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slots_service(void);
+
+/***************************************************************************
+ * Responder: a final message of another exchange was received.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slots_collision(void);
+
+/***************************************************************************
+ * Tag: wait for the beacon, request a slot if the tag has none and return
+ * at the start of the own slot.
+ *
+ * @return false if the device state changed to sleep
+ *
+****************************************************************************/
+bool sit_slots_wait(void);
+
+/***************************************************************************
+ * Tag: time until the end of the own slot.
+ *
+ * @return remaining time in us, 0 if the tag has no slot
+ *
+****************************************************************************/
+uint32_t sit_slots_remaining_us(void);
+
+/***************************************************************************
+ * Tag: release the own slot.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_slots_release(void);
+
+#endif // __SIT_SLOTS_H__
@@ -0,0 +1,84 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_sniff.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the sniff mode for idle responders.
+ *
+ * Without a poll for CONFIG_SIT_SNIFF_IDLE_MS a responder switches the
+ * receiver to the DW3000 sniff mode: during the preamble hunt the 
+ * receiver is on for CONFIG_SIT_SNIFF_ON_PAC + 1 PACs and off for 
+ * CONFIG_SIT_SNIFF_OFF_US. The first poll switches back to full RX.
+ * A longer off time saves more power but lowers the chance to detect the
+ * first poll, the off time has to be shorter than the preamble.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_SNIFF_H__
+#define __SIT_SNIFF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t wakeups;               ///< switches from sniff to full RX
+    uint32_t wakeups_per_minute;    ///< wake ups in the last full minute
+    uint64_t sniff_ms;              ///< time in sniff mode
+    uint64_t full_ms;               ///< time in full RX
+} sit_sniff_stats_t;
+
+/***************************************************************************
+ * Start in full RX and reset the counters
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_sniff_reset(void);
+
+/***************************************************************************
+ * Enable the receiver in the current mode, in full RX with the idle
+ * timeout, in sniff mode without timeout.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_sniff_receive(void);
+
+/***************************************************************************
+ * Switch the mode after a receive
+ *
+ * @param bool traffic -> true if a poll for this responder is received
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_sniff_update(bool traffic);
+
+/***************************************************************************
+ * Get the counters of the sniff mode
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_sniff_get_stats(sit_sniff_stats_t *stats);
+
+#endif // __SIT_SNIFF_H__
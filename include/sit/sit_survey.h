@@ -0,0 +1,58 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_survey.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the anchor auto-survey.
+ *
+ * In survey mode every anchor ranges to every other anchor with DS-TWR.
+ * A token is passed from anchor 100 to the last anchor, the anchor which
+ * holds the token polls all others, the others answer and average the
+ * distance to the polling anchor. Afterwards anchor 100 collects the
+ * distances of every anchor, solves the relative anchor positions with
+ * sit_mds_solve() and notifies them over BLE.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_SURVEY_H__
+#define __SIT_SURVEY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_SURVEY_MEASUREMENTS
+#define CONFIG_SIT_SURVEY_MEASUREMENTS 10
+#endif
+
+/** Device id of the anchor which starts the survey and solves the positions */
+#define SIT_SURVEY_MASTER_ID 100
+
+/***************************************************************************
+ * Run the survey on an anchor, returns when the survey is done or the
+ * device state changes to sleep.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_survey_run(void);
+
+#endif // __SIT_SURVEY_H__
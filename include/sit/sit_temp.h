@@ -0,0 +1,84 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_temp.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the temperature compensation.
+ *
+ * The PG delay (bandwidth) and the antenna delays of the DW3000 drift with
+ * the temperature. Every CONFIG_SIT_TEMP_PERIOD_MS the temperature is read,
+ * the PG delay is recalibrated to the PG count of the boot reference and
+ * the antenna delays are shifted by the temperature coefficient of the 
+ * device. The service runs in the ranging thread and only in an idle gap
+ * of at least CONFIG_SIT_TEMP_MIN_IDLE_MS, so it never takes a ranging slot.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_TEMP_H__
+#define __SIT_TEMP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <deca_device_api.h>
+
+/***************************************************************************
+ * Take the reference PG count and temperature, call after 
+ * dwt_configuretxrf() in sit_init()
+ *
+ * @param config    -> TX spectrum config, PGdly and PGcount are updated
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_temp_init(dwt_txconfig_t *config);
+
+/***************************************************************************
+ * Run the compensation if it is due and the idle gap is long enough.
+ *
+ * @param idle_ms   -> time until the next ranging slot
+ *
+ * @return true if the compensation was run
+ *
+****************************************************************************/
+bool sit_temp_service(int64_t idle_ms);
+
+/***************************************************************************
+ * Write the compensated PG delay and antenna delays again, e.g. after
+ * a wake up from deep sleep or a new antenna delay. Does nothing before
+ * sit_temp_init().
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_temp_apply(void);
+
+/***************************************************************************
+ * Get the last measured DW3000 temperature in degree Celsius.
+ *
+ * @return temperature
+ *
+****************************************************************************/
+float sit_temp_get(void);
+
+#endif // __SIT_TEMP_H__
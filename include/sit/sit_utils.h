@@ -55,3 +55,24 @@ uint64_t get_tx_timestamp_u64(void);
  */
 uint64_t get_rx_timestamp_u64(void);
 
+#define TIMESTAMP_U40_MASK 0xFFFFFFFFFFULL
+
+/********************************************************************************
+ * @brief Write a 40-bit time-stamp into a msg field (5 bytes, little endian).
+ *
+ * @param  field -> msg field
+ * @param  ts    -> time-stamp, the upper 24 bits are ignored
+ *
+ * @return  none
+ */
+void set_timestamp_u40(uint8_t *field, uint64_t ts);
+
+/********************************************************************************
+ * @brief Read a 40-bit time-stamp from a msg field (5 bytes, little endian).
+ *
+ * @param  field -> msg field
+ *
+ * @return  64-bit value of the time-stamp.
+ */
+uint64_t get_timestamp_u40(const uint8_t *field);
+
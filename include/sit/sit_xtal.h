@@ -0,0 +1,83 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_xtal.h
+ * @author agent
+ * @date 19.10.2026
+ * @brief Defniton of the closed loop crystal trim.
+ *
+ * The clock offset to a reference anchor (from the carrier integrator) is
+ * averaged over CONFIG_SIT_XTAL_SAMPLES exchanges, then the crystal trim is
+ * moved by the mean offset divided by the estimated ppm per trim step. The
+ * slope (and its sign) is re-estimated after every step, so the loop does
+ * not depend on the exact load capacitance of the board.
+ *
+ * @bug No known bugs.
+ */
+
+#ifndef __SIT_XTAL_H__
+#define __SIT_XTAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CONFIG_SIT_XTAL_SAMPLES
+#define CONFIG_SIT_XTAL_SAMPLES 10
+#endif
+
+#ifndef CONFIG_SIT_XTAL_TARGET_PPM_X10
+#define CONFIG_SIT_XTAL_TARGET_PPM_X10 20
+#endif
+
+#define SIT_XTAL_TRIM_MAX       0x3F
+#define SIT_XTAL_MAX_STEP       8
+#define SIT_XTAL_PPM_PER_STEP   1.5f // start value of the slope estimation
+
+typedef struct {
+    uint8_t trim;           ///< current trim value
+    bool converged;         ///< mean offset within the target
+    float ppm_per_step;     ///< estimated trim slope, sign included
+    float sum;
+    uint8_t samples;
+    float last_mean;        ///< mean offset before the last step
+    int8_t last_step;       ///< last trim change, 0 if none
+} sit_xtal_t;
+
+/***************************************************************************
+ * Start the loop from a trim value.
+ *
+ * @return None
+ *
+****************************************************************************/
+void sit_xtal_reset(sit_xtal_t *xtal, uint8_t trim);
+
+/***************************************************************************
+ * Add one clock offset measurement.
+ *
+ * @param offset_ppm    -> clock offset in ppm, positive if the local clock
+ *                         is slower than the reference
+ *
+ * @return true if xtal->trim changed and has to be written
+ *
+****************************************************************************/
+bool sit_xtal_update(sit_xtal_t *xtal, float offset_ppm);
+
+#endif // __SIT_XTAL_H__
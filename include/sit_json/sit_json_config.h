@@ -15,24 +15,46 @@ extern "C"
 #include <string.h>
 #include <zephyr/data/json.h>
 
+#include <sit/sit_nlos.h>
+#include <sit/sit_position.h>
+
 #include "sit_json_config.h"
 typedef struct {
     char type[16];
     char command[6];
 } json_command_msg_t;
 
+/** Max positions for the extended calibration (range of CONFIG_SIT_ALL_TWR_MAX_NODES) */
+#define JSON_CALIBRATION_MAX_DEVICES 20
+
+/** Max provisioned anchors (range of CONFIG_SIT_POSITION_MAX_ANCHORS) */
+#define JSON_MAX_ANCHORS SIT_POSITION_MAX_ANCHORS
+
 typedef struct {
     char type[16];
     char initiator_device[17];
     uint8_t initiator;
-    char responder_device[4][17];
-    uint8_t responder;
+    uint16_t tag_id;
+    char responder_device[JSON_MAX_ANCHORS][17];
+    uint16_t responder;     ///< number of responders, addresses 100..100 + responder - 1
+    float anchor_position[JSON_MAX_ANCHORS][3];
+    uint8_t anchors;
+    float calibration_distance[3];
+    float calibration_position[JSON_CALIBRATION_MAX_DEVICES][3];
+    uint8_t calibration_positions;
+    bool ant_dly_temp_coeff_set;
+    float ant_dly_temp_coeff;
     uint32_t min_measurement;
     uint32_t max_measurement;
     char measurement_type[11];
     char device_type[10];
     uint16_t rx_ant_dly;
     uint16_t tx_ant_dly;
+    bool nlos_model;
+    float nlos_mean[SIT_NLOS_FEATURES];
+    float nlos_scale[SIT_NLOS_FEATURES];
+    float nlos_weight[SIT_NLOS_FEATURES];
+    float nlos_bias;
 } json_setup_msg_t;
 
 #ifdef __cplusplus
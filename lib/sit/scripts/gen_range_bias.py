@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026  agent
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+"""Range bias tables for the SIT distance correction.
+
+Generates sit_range_bias_tables.h at build time: one table per channel
+(5/9) and PRF (16/64 MHz), bias in mm over the received signal level in
+equidistant dB steps. The firmware interpolates linearly in integer math.
+
+The default points follow the shape of the range bias curves of Qorvo
+APS011. Replace them with measured points:
+
+    gen_range_bias.py --points bias.csv --output tables.h
+
+    bias.csv: channel,prf,rsl_dbm,bias_cm
+
+Check a table against a recorded dataset on the host:
+
+    gen_range_bias.py --points bias.csv --evaluate dataset.csv
+
+    dataset.csv: channel,prf,rsl_dbm,measured_m,true_m
+
+range_bias_dataset.csv is a synthetic example (channel 5 and 9, 64 MHz
+PRF, 1..40 m): the bias of the default points plus 2 cm noise. It checks
+the tables and the integer interpolation, not the bias curve itself.
+"""
+
+import argparse
+import csv
+import math
+import sys
+
+RSL_MIN_DBM = -95
+RSL_MAX_DBM = -61
+RSL_STEP_DBM = 2
+Q = 8
+
+# bias (measured - true) in cm over RSL in dBm
+DEFAULT_POINTS = {
+    (5, 64): [(-95, 8.5), (-93, 8.1), (-91, 7.6), (-89, 7.1), (-87, 6.2),
+              (-85, 4.9), (-83, 4.2), (-81, 3.5), (-79, 2.1), (-77, 0.0),
+              (-75, -2.7), (-73, -5.1), (-71, -6.9), (-69, -8.2),
+              (-67, -9.3), (-65, -10.0), (-63, -10.5), (-61, -11.0)],
+    (5, 16): [(-95, 11.0), (-91, 9.8), (-87, 7.9), (-83, 5.1), (-79, 2.3),
+              (-77, 0.0), (-75, -3.1), (-71, -7.6), (-67, -10.4),
+              (-63, -11.8), (-61, -12.3)],
+    (9, 64): [(-95, 9.2), (-91, 8.0), (-87, 6.6), (-83, 4.5), (-79, 2.2),
+              (-77, 0.5), (-75, -2.1), (-71, -6.3), (-67, -8.8),
+              (-63, -10.1), (-61, -10.6)],
+    (9, 16): [(-95, 11.8), (-91, 10.2), (-87, 8.3), (-83, 5.6), (-79, 2.6),
+              (-77, 0.4), (-75, -2.8), (-71, -7.2), (-67, -10.0),
+              (-63, -11.4), (-61, -11.9)],
+}
+
+
+def read_points(path):
+    points = {}
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            key = (int(row["channel"]), int(row["prf"]))
+            points.setdefault(key, []).append(
+                (float(row["rsl_dbm"]), float(row["bias_cm"])))
+    for key in points:
+        points[key].sort()
+    return points
+
+
+def resample(points):
+    """Bias in mm at every table step, clamped outside the points."""
+    table = []
+    for rsl in range(RSL_MIN_DBM, RSL_MAX_DBM + 1, RSL_STEP_DBM):
+        if rsl <= points[0][0]:
+            bias = points[0][1]
+        elif rsl >= points[-1][0]:
+            bias = points[-1][1]
+        else:
+            for (x0, y0), (x1, y1) in zip(points, points[1:]):
+                if x0 <= rsl <= x1:
+                    bias = y0 + (y1 - y0) * (rsl - x0) / (x1 - x0)
+                    break
+        table.append(int(round(bias * 10)))
+    return table
+
+
+def bias_mm(table, rsl_q8):
+    """Same integer interpolation as sit_range_bias_mm()."""
+    rsl_min = RSL_MIN_DBM << Q
+    step = RSL_STEP_DBM << Q
+    if rsl_q8 <= rsl_min:
+        return table[0]
+    offset = rsl_q8 - rsl_min
+    index = offset // step
+    if index >= len(table) - 1:
+        return table[-1]
+    fraction = offset % step
+    # C division truncates towards zero
+    delta = (table[index + 1] - table[index]) * fraction
+    return table[index] + int(delta / step)
+
+
+def evaluate(tables, path):
+    raw = []
+    corrected = []
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            key = (int(row["channel"]), int(row["prf"]))
+            measured_mm = int(round(float(row["measured_m"]) * 1000))
+            true_mm = float(row["true_m"]) * 1000
+            rsl_q8 = int(float(row["rsl_dbm"]) * (1 << Q))
+            raw.append(measured_mm - true_mm)
+            corrected.append(measured_mm - bias_mm(tables[key], rsl_q8) - true_mm)
+    if not raw:
+        sys.exit("empty dataset")
+
+    def stats(errors):
+        mean = sum(errors) / len(errors)
+        rms = math.sqrt(sum(e * e for e in errors) / len(errors))
+        return mean, rms
+
+    for name, errors in (("raw", raw), ("corrected", corrected)):
+        mean, rms = stats(errors)
+        print(f"{name:>9}: mean {mean:7.1f} mm, rms {rms:7.1f} mm, n {len(errors)}")
+
+
+def write_header(tables, path):
+    length = (RSL_MAX_DBM - RSL_MIN_DBM) // RSL_STEP_DBM + 1
+    lines = [
+        "/* Generated by gen_range_bias.py, do not edit. */",
+        "",
+        "#ifndef __SIT_RANGE_BIAS_TABLES_H__",
+        "#define __SIT_RANGE_BIAS_TABLES_H__",
+        "",
+        "#include <stdint.h>",
+        "",
+        f"#define SIT_RANGE_BIAS_RSL_MIN_Q8 ({RSL_MIN_DBM} * 256)",
+        f"#define SIT_RANGE_BIAS_STEP_Q8    ({RSL_STEP_DBM} * 256)",
+        f"#define SIT_RANGE_BIAS_LEN        {length}",
+        "",
+    ]
+    for (channel, prf) in sorted(tables):
+        values = ", ".join(str(v) for v in tables[(channel, prf)])
+        lines.append(f"static const int16_t sit_range_bias_ch{channel}_prf{prf}"
+                     f"[SIT_RANGE_BIAS_LEN] = {{{values}}};")
+    lines += ["", "#endif // __SIT_RANGE_BIAS_TABLES_H__", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--points", help="measured bias points (csv)")
+    parser.add_argument("--output", help="generated header")
+    parser.add_argument("--evaluate", help="recorded dataset (csv)")
+    args = parser.parse_args()
+
+    points = dict(DEFAULT_POINTS)
+    if args.points:
+        points.update(read_points(args.points))
+    tables = {key: resample(value) for key, value in points.items()}
+
+    if args.output:
+        write_header(tables, args.output)
+    if args.evaluate:
+        evaluate(tables, args.evaluate)
+
+
+if __name__ == "__main__":
+    main()
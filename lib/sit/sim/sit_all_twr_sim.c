@@ -0,0 +1,142 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_all_twr_sim.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Host simulation of the all-pairs ranging (ds_all_twr).
+ *
+ * N nodes at random positions in a 20 m x 20 m room, every clock with a
+ * random offset and a drift of up to +-20 ppm, 150 ps timestamp noise and
+ * a frame loss rate. Node 0 calculates all pairwise distances after every
+ * round and the error against the true distance is collected.
+ *
+ * Not part of the firmware build:
+ *
+ *   cc -O2 -I include lib/sit/sim/sit_all_twr_sim.c lib/sit/sit_all_pairs.c \
+ *      -DCONFIG_SIT_ALL_TWR_MAX_NODES=32 -lm -o all_twr_sim
+ *   ./all_twr_sim [nodes] [rounds] [loss %]
+ *
+ * @bug No known bugs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sit/sit_all_pairs.h"
+
+#define DWT_TIME_UNITS      (1.0 / 499.2e6 / 128.0)
+#define SPEED_OF_LIGHT      299702547.0
+#define SLOT_S              1e-3
+#define NOISE_S             150e-12
+#define ROOM_M              20.0
+
+static double uniform(void) {
+    return (double)rand() / RAND_MAX;
+}
+
+static double gaussian(void) {
+    double u1 = uniform() + 1e-12;
+    double u2 = uniform();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+typedef struct {
+    double x, y;
+    double offset_s;
+    double drift;
+} node_t;
+
+static uint64_t local_ts(const node_t *node, double t) {
+    double local = (t * (1.0 + node->drift) + node->offset_s) / DWT_TIME_UNITS;
+    return (uint64_t)fmod(local, 1099511627776.0);
+}
+
+int main(int argc, char **argv) {
+    int nodes = argc > 1 ? atoi(argv[1]) : 8;
+    int rounds = argc > 2 ? atoi(argv[2]) : 200;
+    double loss = argc > 3 ? atof(argv[3]) / 100.0 : 0.0;
+    static node_t node[SIT_ALL_PAIRS_MAX_NODES];
+    static sit_all_pairs_t ctx[SIT_ALL_PAIRS_MAX_NODES];
+
+    if (nodes < 2 || nodes > SIT_ALL_PAIRS_MAX_NODES) {
+        fprintf(stderr, "nodes 2..%d\n", SIT_ALL_PAIRS_MAX_NODES);
+        return 1;
+    }
+    srand(1);
+    for (int i = 0; i < nodes; i++) {
+        node[i].x = uniform() * ROOM_M;
+        node[i].y = uniform() * ROOM_M;
+        node[i].offset_s = uniform() * 17.0;
+        node[i].drift = (uniform() * 40.0 - 20.0) * 1e-6;
+        sit_all_pairs_init(&ctx[i], i, nodes);
+    }
+
+    double sum = 0.0, max = 0.0;
+    long count = 0, expected = 0;
+    uint16_t max_payload = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < nodes; i++) {
+            double t = (r * nodes + i) * SLOT_S;
+            sit_all_pairs_frame_t frame, received;
+            uint8_t buffer[SIT_ALL_PAIRS_MAX_PAYLOAD];
+            sit_all_pairs_build(&ctx[i], (uint8_t)r, local_ts(&node[i], t), &frame);
+            uint16_t length = sit_all_pairs_pack(&frame, buffer);
+            if (length > max_payload) {
+                max_payload = length;
+            }
+            sit_all_pairs_unpack(buffer, length, i, &received);
+            for (int j = 0; j < nodes; j++) {
+                if (j == i || uniform() < loss) {
+                    continue;
+                }
+                double d = hypot(node[i].x - node[j].x, node[i].y - node[j].y);
+                double t_rx = t + d / SPEED_OF_LIGHT + gaussian() * NOISE_S;
+                sit_all_pairs_receive(&ctx[j], &received, local_ts(&node[j], t_rx));
+            }
+        }
+        if (r < 2) {
+            continue;
+        }
+        for (int a = 0; a < nodes; a++) {
+            for (int b = a + 1; b < nodes; b++) {
+                double tof;
+                expected++;
+                if (!sit_all_pairs_tof(&ctx[0], a, b, &tof)) {
+                    continue;
+                }
+                double d = hypot(node[a].x - node[b].x, node[a].y - node[b].y);
+                double error = tof * DWT_TIME_UNITS * SPEED_OF_LIGHT - d;
+                sum += error * error;
+                max = fabs(error) > max ? fabs(error) : max;
+                count++;
+            }
+        }
+    }
+
+    int pairs = nodes * (nodes - 1) / 2;
+    printf("nodes %d, loss %.0f %%: frames/round %d (pairwise DS-TWR %d), max payload %u bytes\n",
+           nodes, loss * 100.0, nodes, 3 * pairs, max_payload);
+    printf("  distances %ld/%ld, rms %.3f m, max %.3f m\n",
+           count, expected, count ? sqrt(sum / count) : 0.0, max);
+    return 0;
+}
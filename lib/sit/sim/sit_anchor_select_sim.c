@@ -0,0 +1,195 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_anchor_select_sim.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Host check of the anchor subset selection.
+ *
+ * Runs sit_anchor_select() on synthetic layouts for tag positions on a
+ * grid and compares the weighted GDOP of the chosen K anchors with the
+ * best subset of a brute force search over all subsets of size K:
+ *
+ *  - square:   4 corners and a redundant anchor on a line between two of
+ *              them, K = 4
+ *  - nlos:     5 anchors, one link degraded by NLOS (link quality from
+ *              sit_anchor_link_update()), K = 4
+ *  - random:   random layouts with 8 anchors and random link quality,
+ *              K = 4, only reported (greedy + swap is a heuristic)
+ *
+ * The program fails if a square or nlos selection is not optimal.
+ *
+ * Not part of the firmware build:
+ *
+ *   cc -O2 -I include lib/sit/sim/sit_anchor_select_sim.c lib/sit/sit_anchor_select.c \
+ *      -lm -o anchor_select_sim
+ *   ./anchor_select_sim
+ *
+ * @bug No known bugs.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sit/sit_anchor_select.h"
+
+#define K               4
+#define GRID_STEP_M     0.5f
+#define RANDOM_LAYOUTS  1000
+#define ROOM_M          20.0f
+#define GDOP_TOLERANCE  1e-4f
+
+typedef struct {
+    uint32_t checks;
+    uint32_t optimal;
+    float worst_ratio;
+} sim_result_t;
+
+static float uniform(void) {
+    return (float)rand() / RAND_MAX;
+}
+
+/* Lowest GDOP of all subsets of size k without the unusable anchors */
+static float brute_force_gdop(
+    const sit_vec3_t *anchors,
+    const float *quality,
+    uint8_t count,
+    const sit_vec3_t *position,
+    bool solve_3d,
+    uint8_t k
+) {
+    float best = FLT_MAX;
+    uint8_t subset[SIT_POSITION_MAX_ANCHORS];
+    for (uint32_t mask = 0; mask < (1u << count); mask++) {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (mask & (1u << i)) {
+                if (quality[i] < SIT_ANCHOR_MIN_QUALITY || n == k) {
+                    n = k + 1;
+                    break;
+                }
+                subset[n++] = i;
+            }
+        }
+        if (n != k) {
+            continue;
+        }
+        float gdop = sit_anchor_gdop(anchors, quality, subset, n, position, solve_3d);
+        if (gdop < best) {
+            best = gdop;
+        }
+    }
+    return best;
+}
+
+static void check_position(
+    const sit_vec3_t *anchors,
+    const float *quality,
+    uint8_t count,
+    const sit_vec3_t *position,
+    sim_result_t *result
+) {
+    uint8_t selected[K];
+    uint8_t n = sit_anchor_select(anchors, quality, count, position, false, K, selected);
+    float best = brute_force_gdop(anchors, quality, count, position, false, K);
+    if (best == FLT_MAX) {
+        return;
+    }
+    float gdop = n == K ? sit_anchor_gdop(anchors, quality, selected, n, position, false) : FLT_MAX;
+    float ratio = gdop / best;
+    result->checks++;
+    if (ratio <= 1.0f + GDOP_TOLERANCE) {
+        result->optimal++;
+    }
+    if (ratio > result->worst_ratio) {
+        result->worst_ratio = ratio;
+    }
+}
+
+static void check_grid(
+    const sit_vec3_t *anchors,
+    const float *quality,
+    uint8_t count,
+    float width,
+    float height,
+    sim_result_t *result
+) {
+    for (float x = GRID_STEP_M / 2; x < width; x += GRID_STEP_M) {
+        for (float y = GRID_STEP_M / 2; y < height; y += GRID_STEP_M) {
+            sit_vec3_t position = {x, y, 1.0f};
+            check_position(anchors, quality, count, &position, result);
+        }
+    }
+}
+
+static void print_result(const char *name, const sim_result_t *result) {
+    printf("%-8s %7u %7u %10.2f %%  %8.4f\n", name, result->checks, result->optimal,
+        result->checks ? 100.0 * result->optimal / result->checks : 0.0, result->worst_ratio);
+}
+
+int main(void) {
+    printf("layout    checks optimal  optimal [%%]  worst GDOP ratio\n");
+
+    // 10 x 10 m square, anchor 4 is redundant on the line between 0 and 1
+    const sit_vec3_t square[] = {
+        {0.0f, 0.0f, 2.5f}, {10.0f, 0.0f, 2.5f}, {10.0f, 10.0f, 2.5f}, {0.0f, 10.0f, 2.5f},
+        {5.0f, 0.0f, 2.5f},
+    };
+    const float square_quality[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    sim_result_t square_result = {0};
+    check_grid(square, square_quality, 5, 10.0f, 10.0f, &square_result);
+    print_result("square", &square_result);
+
+    // 5 anchors around a 12 x 8 m hall, the link to anchor 2 is mostly NLOS
+    const sit_vec3_t hall[] = {
+        {0.0f, 0.0f, 2.5f}, {12.0f, 0.0f, 2.5f}, {12.0f, 8.0f, 2.5f}, {0.0f, 8.0f, 2.5f},
+        {6.0f, 8.0f, 2.5f},
+    };
+    float hall_quality[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    for (uint8_t i = 0; i < 20; i++) {
+        sit_anchor_link_update(&hall_quality[2], i % 3 != 0, 100);
+    }
+    sim_result_t nlos_result = {0};
+    check_grid(hall, hall_quality, 5, 12.0f, 8.0f, &nlos_result);
+    print_result("nlos", &nlos_result);
+
+    srand(1);
+    sim_result_t random_result = {0};
+    for (uint16_t layout = 0; layout < RANDOM_LAYOUTS; layout++) {
+        sit_vec3_t anchors[SIT_POSITION_MAX_ANCHORS];
+        float quality[SIT_POSITION_MAX_ANCHORS];
+        for (uint8_t i = 0; i < SIT_POSITION_MAX_ANCHORS; i++) {
+            anchors[i] = (sit_vec3_t){uniform() * ROOM_M, uniform() * ROOM_M, 2.5f};
+            quality[i] = 0.2f + 0.8f * uniform();
+        }
+        sit_vec3_t position = {uniform() * ROOM_M, uniform() * ROOM_M, 1.0f};
+        check_position(anchors, quality, SIT_POSITION_MAX_ANCHORS, &position, &random_result);
+    }
+    print_result("random", &random_result);
+
+    if (square_result.optimal != square_result.checks || nlos_result.optimal != nlos_result.checks) {
+        printf("FAIL: selection is not the brute force optimum\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
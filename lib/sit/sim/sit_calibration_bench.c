@@ -0,0 +1,121 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_calibration_bench.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Host benchmark of the extended antenna delay calibration.
+ *
+ * 3..20 devices at random positions with random antenna delay errors
+ * (+-100 DWT time units), every pair measures its time of flight
+ * CONFIG_SIT_CALIBRATION_ROUNDS times with 10 DWT time units noise and a
+ * random pair bias of 2 DWT time units (multipath). Reports the time of
+ * sit_calibration_n_solve() and the error of the estimated delays.
+ *
+ * Not part of the firmware build:
+ *
+ *   cc -O2 -I include lib/sit/sim/sit_calibration_bench.c lib/sit/sit_calibration.c \
+ *      -DCONFIG_SIT_ALL_TWR_MAX_NODES=20 -lm -o calibration_bench
+ *   ./calibration_bench [loss %]
+ *
+ * @bug No known bugs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sit/sit_calibration.h"
+
+#define DWT_TIME_UNITS      (1.0 / 499.2e6 / 128.0)
+#define SPEED_OF_LIGHT      299702547.0
+#define NOISE_DTU           10.0
+#define PAIR_BIAS_DTU       2.0
+#define ROOM_M              20.0
+#define SOLVE_REPEAT        1000
+
+static double uniform(void) {
+    return (double)rand() / RAND_MAX;
+}
+
+static double gaussian(void) {
+    double u1 = uniform() + 1e-12;
+    double u2 = uniform();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char **argv) {
+    double loss = argc > 1 ? atof(argv[1]) / 100.0 : 0.0;
+    static sit_calibration_n_t calibration;
+    sit_calibration_n_result_t result;
+    double x[SIT_CALIBRATION_MAX_DEVICES], y[SIT_CALIBRATION_MAX_DEVICES];
+    double delay[SIT_CALIBRATION_MAX_DEVICES];
+
+    srand(1);
+    printf("devices pairs  solve [us]  max error [DTU]  max std [DTU]\n");
+    for (uint8_t devices = 3; devices <= SIT_CALIBRATION_MAX_DEVICES; devices++) {
+        sit_calibration_n_reset(&calibration, devices);
+        for (uint8_t i = 0; i < devices; i++) {
+            x[i] = uniform() * ROOM_M;
+            y[i] = uniform() * ROOM_M;
+            delay[i] = uniform() * 200.0 - 100.0;
+        }
+        for (uint8_t a = 0; a < devices; a++) {
+            for (uint8_t b = a + 1; b < devices; b++) {
+                double tof = hypot(x[a] - x[b], y[a] - y[b]) / SPEED_OF_LIGHT / DWT_TIME_UNITS;
+                double bias = gaussian() * PAIR_BIAS_DTU;
+                sit_calibration_n_set_tof(&calibration, a, b, tof);
+                for (uint32_t r = 0; r < CONFIG_SIT_CALIBRATION_ROUNDS; r++) {
+                    if (uniform() < loss) {
+                        continue;
+                    }
+                    double measured = tof + (delay[a] + delay[b]) / 2.0 + bias + gaussian() * NOISE_DTU;
+                    sit_calibration_n_add(&calibration, a, b, measured);
+                }
+            }
+        }
+
+        double start = now_us();
+        bool solved = false;
+        for (uint16_t i = 0; i < SOLVE_REPEAT; i++) {
+            solved = sit_calibration_n_solve(&calibration, CONFIG_SIT_CALIBRATION_ROUNDS / 2, &result);
+        }
+        double solve_us = (now_us() - start) / SOLVE_REPEAT;
+        if (!solved) {
+            printf("%7u  not solved\n", devices);
+            continue;
+        }
+        double max_error = 0.0, max_std = 0.0;
+        for (uint8_t i = 0; i < devices; i++) {
+            max_error = fmax(max_error, fabs(result.delay[i] - delay[i]));
+            max_std = fmax(max_std, result.std[i]);
+        }
+        printf("%7u %5u  %10.2f  %15.1f  %13.2f\n", devices, result.pairs, solve_us, max_error, max_std);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_nlos_bench.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Host benchmark of the NLOS classifier.
+ *
+ * Synthetic CIR windows of 8..64 taps (the range of
+ * CONFIG_SIT_NLOS_CIR_TAPS) with a line of sight (sharp first path) and a
+ * NLOS shape (slow rise, weak first path) and 5 % noise. Reports the time
+ * of sit_nlos_cir_features() + sit_nlos_probability() per frame, the
+ * features and the probability of the default model.
+ *
+ * The time of the accumulator read on the device is not part of this
+ * benchmark, get_diagnostic() logs the sum of both.
+ *
+ * Not part of the firmware build:
+ *
+ *   cc -O2 -I include lib/sit/sim/sit_nlos_bench.c lib/sit/sit_nlos.c -lm -o nlos_bench
+ *   ./nlos_bench
+ *
+ * @bug No known bugs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sit/sit_nlos.h"
+
+#define MAX_TAPS        64
+#define PRE_TAPS        4       // taps before the first path, as in sit_diagnostic.c
+#define PEAK            8000.0
+#define NOISE           0.05
+#define FRAMES          100000
+
+static double uniform(void) {
+    return (double)rand() / RAND_MAX;
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Amplitude envelope: rise over rise_taps to the peak, exponential decay */
+static void make_cir(int16_t *iq, uint16_t taps, double rise_taps, double decay_taps) {
+    for (uint16_t i = 0; i < taps; i++) {
+        double t = (double)i - PRE_TAPS;
+        double amplitude = 0.0;
+        if (t >= 0.0 && t < rise_taps) {
+            amplitude = PEAK * (t + 1.0) / (rise_taps + 1.0);
+        } else if (t >= rise_taps) {
+            amplitude = PEAK * exp(-(t - rise_taps) / decay_taps);
+        }
+        amplitude += PEAK * NOISE * (uniform() - 0.5);
+        double phase = 2.0 * M_PI * uniform();
+        iq[2 * i] = (int16_t)(amplitude * cos(phase));
+        iq[2 * i + 1] = (int16_t)(amplitude * sin(phase));
+    }
+}
+
+static void bench(const char *name, uint16_t taps, double rise_taps, double decay_taps, int32_t rsl_fpl_db) {
+    static int16_t iq[2 * MAX_TAPS];
+    sit_nlos_model_t model;
+    int32_t features[SIT_NLOS_FEATURES] = {0};
+    uint32_t probability = 0;
+
+    sit_nlos_model_default(&model);
+    make_cir(iq, taps, rise_taps, decay_taps);
+    features[nlos_fp_pp] = (int32_t)rise_taps << SIT_NLOS_Q;
+    features[nlos_rsl_fpl] = rsl_fpl_db << SIT_NLOS_Q;
+
+    double start = now_us();
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        sit_nlos_cir_features(iq, taps, features);
+        probability += sit_nlos_probability(&model, features);
+    }
+    double frame_us = (now_us() - start) / FRAMES;
+
+    printf("%-5s %4u  %10.3f  %11.2f  %8.2f  %6.1f %%\n", name, taps, frame_us,
+        (double)features[nlos_rise_time] / SIT_NLOS_ONE,
+        (double)features[nlos_kurtosis] / SIT_NLOS_ONE,
+        100.0 * probability / FRAMES / SIT_NLOS_PROB_ONE);
+}
+
+int main(void) {
+    srand(1);
+    printf("shape taps  frame [us]  rise [taps]  kurtosis  P(NLOS)\n");
+    for (uint16_t taps = 8; taps <= MAX_TAPS; taps *= 2) {
+        bench("LOS", taps, 1.0, 3.0, 6);
+        bench("NLOS", taps, 6.0, 12.0, 16);
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_position_ransac_test.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Host test of the RANSAC position fix.
+ *
+ * 6 anchors around a 12 x 8 m hall, the tag at random positions at a
+ * known height with 5 cm range noise, x/y is solved (the default without
+ * CONFIG_SIT_POSITION_3D). One random anchor gets +2 m NLOS bias and the prior
+ * of a NLOS frame from sit_position_prior(). The test fails if
+ *
+ *  - the NLOS anchor is not rejected from the consensus set or the fix
+ *    is more than 0.3 m off with the prior weighted sampling,
+ *  - a fix tests more than CONFIG_SIT_POSITION_RANSAC_ITERATIONS
+ *    hypotheses, also with all priors at the minimum and zero,
+ *  - a clean fix does not stop after the first full consensus.
+ *
+ * Uniform sampling (NULL prior) and the plain least-squares fix are only
+ * reported for comparison.
+ *
+ * Not part of the firmware build:
+ *
+ *   cc -O2 -I include lib/sit/sim/sit_position_ransac_test.c lib/sit/sit_position.c \
+ *      -lm -o position_ransac_test
+ *   ./position_ransac_test
+ *
+ * @bug No known bugs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sit/sit_position.h"
+
+#define ANCHORS         6
+#define TRIALS          1000
+#define NOISE_M         0.05f
+#define NLOS_BIAS_M     2.0f
+#define MAX_ERROR_M     0.3f
+#define TAG_Z_M         1.2f
+
+static const sit_vec3_t anchors[ANCHORS] = {
+    {0.0f, 0.0f, 2.5f}, {12.0f, 0.0f, 0.5f}, {12.0f, 8.0f, 2.5f},
+    {0.0f, 8.0f, 0.5f}, {6.0f, 0.0f, 2.0f}, {6.0f, 8.0f, 1.0f},
+};
+
+static float uniform(void) {
+    return (float)rand() / RAND_MAX;
+}
+
+static float gaussian(void) {
+    float u1 = uniform() + 1e-6f;
+    float u2 = uniform();
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
+
+static float fix_error(const sit_position_t *fix, const sit_vec3_t *tag) {
+    return sqrtf((fix->x - tag->x) * (fix->x - tag->x) + (fix->y - tag->y) * (fix->y - tag->y)
+        + (fix->z - tag->z) * (fix->z - tag->z));
+}
+
+/* Ranges from tag to all anchors, the NLOS anchor (or ANCHORS for none) with bias */
+static void measure(const sit_vec3_t *tag, uint8_t nlos_anchor, float *distances) {
+    for (uint8_t i = 0; i < ANCHORS; i++) {
+        float dx = tag->x - anchors[i].x;
+        float dy = tag->y - anchors[i].y;
+        float dz = tag->z - anchors[i].z;
+        distances[i] = sqrtf(dx * dx + dy * dy + dz * dz) + gaussian() * NOISE_M;
+        if (i == nlos_anchor) {
+            distances[i] += NLOS_BIAS_M;
+        }
+    }
+}
+
+int main(void) {
+    uint32_t failures = 0;
+    uint32_t rejected = 0, rejected_uniform = 0;
+    uint32_t max_hypotheses = 0;
+    float max_error = 0.0f, max_error_uniform = 0.0f, max_error_ls = 0.0f;
+    float los_prior = sit_position_prior(0, -80.0f, -81.0f);
+    float nlos_prior = sit_position_prior(100, -80.0f, -95.0f);
+
+    srand(1);
+    for (uint32_t trial = 0; trial < TRIALS; trial++) {
+        sit_vec3_t tag = {1.0f + 10.0f * uniform(), 1.0f + 6.0f * uniform(), TAG_Z_M};
+        uint8_t nlos_anchor = (uint8_t)(rand() % ANCHORS);
+        float distances[ANCHORS];
+        float prior[ANCHORS];
+        measure(&tag, nlos_anchor, distances);
+        for (uint8_t i = 0; i < ANCHORS; i++) {
+            prior[i] = i == nlos_anchor ? nlos_prior : los_prior;
+        }
+
+        sit_position_t fix = {.z = TAG_Z_M};
+        if (!sit_position_solve_robust(anchors, distances, prior, ANCHORS, false, &fix)) {
+            printf("trial %u: no fix\n", trial);
+            failures++;
+            continue;
+        }
+        float error = fix_error(&fix, &tag);
+        max_error = fmaxf(max_error, error);
+        if (fix.hypotheses > max_hypotheses) {
+            max_hypotheses = fix.hypotheses;
+        }
+        if (fix.anchors == ANCHORS - 1 && error < MAX_ERROR_M) {
+            rejected++;
+        } else {
+            printf("trial %u: anchor %u not rejected (%u anchors, error %.2f m)\n",
+                trial, nlos_anchor, fix.anchors, error);
+            failures++;
+        }
+        if (fix.hypotheses > CONFIG_SIT_POSITION_RANSAC_ITERATIONS) {
+            printf("trial %u: %u hypotheses\n", trial, fix.hypotheses);
+            failures++;
+        }
+
+        sit_position_t uniform_fix = {.z = TAG_Z_M};
+        if (sit_position_solve_robust(anchors, distances, NULL, ANCHORS, false, &uniform_fix)) {
+            float uniform_error = fix_error(&uniform_fix, &tag);
+            max_error_uniform = fmaxf(max_error_uniform, uniform_error);
+            if (uniform_fix.anchors == ANCHORS - 1 && uniform_error < MAX_ERROR_M) {
+                rejected_uniform++;
+            }
+        }
+
+        sit_position_t ls_fix = {.z = TAG_Z_M};
+        if (sit_position_solve(anchors, distances, ANCHORS, false, &ls_fix)) {
+            max_error_ls = fmaxf(max_error_ls, fix_error(&ls_fix, &tag));
+        }
+    }
+
+    // worst case: no full consensus and no usable prior, the loop must still end
+    const float low_priors[] = {0.05f, 0.0f};
+    for (uint8_t p = 0; p < 2; p++) {
+        sit_vec3_t tag = {4.0f, 3.0f, TAG_Z_M};
+        float distances[ANCHORS];
+        float prior[ANCHORS];
+        measure(&tag, 0, distances);
+        distances[3] -= NLOS_BIAS_M;
+        for (uint8_t i = 0; i < ANCHORS; i++) {
+            prior[i] = low_priors[p];
+        }
+        sit_position_t fix = {.z = TAG_Z_M};
+        sit_position_solve_robust(anchors, distances, prior, ANCHORS, false, &fix);
+        printf("prior %.2f, 2 outliers: %u hypotheses\n", low_priors[p], fix.hypotheses);
+        if (fix.hypotheses != CONFIG_SIT_POSITION_RANSAC_ITERATIONS) {
+            failures++;
+        }
+    }
+
+    // all anchors line of sight: the first hypothesis is a full consensus
+    {
+        sit_vec3_t tag = {4.0f, 3.0f, TAG_Z_M};
+        float distances[ANCHORS];
+        measure(&tag, ANCHORS, distances);
+        sit_position_t fix = {.z = TAG_Z_M};
+        sit_position_solve_robust(anchors, distances, NULL, ANCHORS, false, &fix);
+        printf("clean: %u hypotheses\n", fix.hypotheses);
+        if (fix.hypotheses != 1 || fix.anchors != ANCHORS) {
+            failures++;
+        }
+    }
+
+    printf("NLOS +%.1f m, %u trials, prior LOS %.2f NLOS %.2f\n",
+        NLOS_BIAS_M, TRIALS, los_prior, nlos_prior);
+    printf("  prior sampling:   rejected %4u, max error %.2f m, max hypotheses %u/%u\n",
+        rejected, max_error, max_hypotheses, CONFIG_SIT_POSITION_RANSAC_ITERATIONS);
+    printf("  uniform sampling: rejected %4u, max error %.2f m\n", rejected_uniform, max_error_uniform);
+    printf("  least-squares:    max error %.2f m\n", max_error_ls);
+
+    if (failures) {
+        printf("FAIL: %u\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
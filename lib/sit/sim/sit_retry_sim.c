@@ -0,0 +1,95 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_retry_sim.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Host simulation of the in-cycle retry policy.
+ *
+ * One initiator polls 4 responders per cycle in a 20 ms slot, every
+ * exchange takes 4 ms and fails with the given probability (independent
+ * losses). A failed exchange is repeated as long as sit_retry_allowed()
+ * permits it. Reports the share of responders with a range per cycle
+ * without retries (first attempt only) and with retries, from the
+ * sit_retry statistic.
+ *
+ * Not part of the firmware build:
+ *
+ *   cc -O2 -I include lib/sit/sim/sit_retry_sim.c lib/sit/sit_retry.c -o retry_sim
+ *   ./retry_sim
+ *
+ * @bug No known bugs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sit/sit_retry.h"
+
+#define RESPONDERS      4
+#define EXCHANGE_US     4000
+#define SLOT_US         20000
+#define CYCLES          100000
+
+static bool exchange(uint8_t loss_percent) {
+    return (uint32_t)rand() % 100 >= loss_percent;
+}
+
+int main(void) {
+    static sit_retry_stats_t stats;
+
+    srand(1);
+    printf("%u responders, %u ms exchange, %u ms slot, %u cycles\n",
+        RESPONDERS, EXCHANGE_US / 1000, SLOT_US / 1000, CYCLES);
+    printf("loss  without retry  with retry  retries/cycle  recovered\n");
+    for (uint8_t loss = 10; loss <= 40; loss += 10) {
+        uint32_t first_attempt = 0;
+        sit_retry_reset(&stats);
+        for (uint32_t cycle = 0; cycle < CYCLES; cycle++) {
+            uint32_t elapsed_us = 0;
+            for (uint16_t r = 0; r < RESPONDERS; r++) {
+                uint8_t attempts = 0;
+                bool success;
+                do {
+                    attempts++;
+                    elapsed_us += EXCHANGE_US;
+                    success = exchange(loss);
+                    if (attempts == 1 && success) {
+                        first_attempt++;
+                    }
+                } while (!success && elapsed_us < SLOT_US
+                    && sit_retry_allowed(attempts, EXCHANGE_US, SLOT_US - elapsed_us, RESPONDERS - r - 1));
+                sit_retry_record(&stats, 100 + r, attempts, success);
+            }
+        }
+
+        uint32_t ranges = 0, retries = 0, recovered = 0;
+        for (uint16_t i = 0; i < stats.count; i++) {
+            ranges += stats.ranges[i];
+            retries += stats.retries[i];
+            recovered += stats.recovered[i];
+        }
+        double polls = (double)RESPONDERS * CYCLES;
+        printf("%3u %%  %12.1f %%  %8.1f %%  %13.2f  %9u\n", loss,
+            100.0 * first_attempt / polls, 100.0 * ranges / polls,
+            (double)retries / CYCLES, recovered);
+    }
+    return 0;
+}
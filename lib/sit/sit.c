@@ -37,6 +37,59 @@
 #include "sit/sit_device.h"
 #include "sit/sit_distance.h"
 #include "sit/sit_utils.h"
+#include "sit/sit_boot.h"
+#include "sit/sit_sequence.h"
+#ifdef CONFIG_SIT_POSITION
+	#include "sit/sit_position.h"
+#endif
+#ifdef CONFIG_SIT_ANCHOR_SELECT
+	#include "sit/sit_anchor_select.h"
+#endif
+#ifdef CONFIG_SIT_SURVEY
+	#include "sit/sit_survey.h"
+#endif
+#ifdef CONFIG_SIT_ALL_TWR
+	#include "sit/sit_all_twr.h"
+#endif
+#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+	#include "sit/sit_calibration.h"
+#endif
+#ifdef CONFIG_SIT_DISCOVERY
+	#include "sit/sit_discovery.h"
+#endif
+#ifdef CONFIG_SIT_SLOTS
+	#include "sit/sit_slots.h"
+#endif
+#ifdef CONFIG_SIT_RETRY
+	#include "sit/sit_retry.h"
+#endif
+#ifdef CONFIG_SIT_SETTINGS
+	#include "sit/sit_settings.h"
+#endif
+#ifdef CONFIG_SIT_POWER_SLEEP
+	#include "sit/sit_power.h"
+#endif
+#ifdef CONFIG_SIT_RX_WINDOW
+	#include "sit/sit_rx_window.h"
+#endif
+#ifdef CONFIG_SIT_SNIFF
+	#include "sit/sit_sniff.h"
+#endif
+#ifdef CONFIG_SIT_CIR
+	#include "sit/sit_cir.h"
+#endif
+#ifdef CONFIG_SIT_RANGE_BIAS
+	#include "sit/sit_range_bias.h"
+#endif
+#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+	#include "sit/sit_diagnostic.h"
+#endif
+#ifdef CONFIG_SIT_TEMP_COMP
+	#include "sit/sit_temp.h"
+#endif
+#ifdef CONFIG_SIT_XTAL_TRIM
+	#include "sit/sit_xtal.h"
+#endif
 #include <sit_led/sit_led.h>
 
 #include <sit_ble/ble_init.h>
@@ -47,16 +100,41 @@
 #include <deca_device_api.h>
 #include <port.h>
 
+#include <math.h>
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(SIT_Module, LOG_LEVEL_INF);
 
 #define DGC_CFG_ID 0x03
 
+/* Ranging period of the initiator */
+#define TWR_PERIOD_MS 100
+
+/* Address of the first anchor, the setup numbers the anchors from here */
+#define ANCHOR_BASE_ID 100
+
+/* SS-TWR: the initiator listens shortly before the response, preamble + margin */
+#define SS_POLL_TX_TO_RESP_RX_DLY_UUS (CONFIG_SIT_SSTWR_REPLY_UUS - 300)
+#define SS_RESP_RX_TIMEOUT_UUS 1000
+
+/* Exchanges per SS-TWR / DS-TWR statistics report */
+#define TWR_STATS_REPORT 100
+
+/* Without the raw stream over BLE the calibration rounds can run faster */
+#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+	#define CALIBRATION_ROUND_DELAY_MS 20
+	#define CALIBRATION_LISTEN_DELAY_MS 5
+#else
+	#define CALIBRATION_ROUND_DELAY_MS 1000
+	#define CALIBRATION_LISTEN_DELAY_MS 500
+#endif
+
 extern dwt_config_t sit_device_config;
 
 /**
  * Values for the PG_DELAY and TX_POWER registers reflect the bandwidth and power of the spectrum at the current
  * temperature. These values can be calibrated prior to taking reference measurements. 
+ * With CONFIG_SIT_TEMP_COMP the PG delay is recalibrated when the temperature changes.
  */
 dwt_txconfig_t txconfig_options_ch9_sit = {
     0x34,       /* PG delay. */
@@ -64,16 +142,15 @@ dwt_txconfig_t txconfig_options_ch9_sit = {
     0x0         /*PG count*/
 };
 
-uint32_t sequence = 0;
-uint32_t measurements = 0;
-double distance = 0.0;
-double time_round_1 = 0.0, time_round_2 = 0.0;
-double time_reply_1 = 0.0, time_reply_2 = 0.0;
-double time_tc_i = 0.0, time_tc_ii = 0.0;
-double time_tb_i = 0.0, time_tb_ii = 0.0;
-double time_m21 = 0.0, time_m31 = 0.0; 
-double time_a21 = 0.0, time_a31 = 0.0;
-double time_b21 = 0.0, time_b31 = 0.0;
+sit_session_t initiator_session;
+sit_session_t responder_session;
+/* Sensing rounds of the two device calibration */
+static sit_session_t calibration_session;
+static double time_tc_i = 0.0, time_tc_ii = 0.0;
+static double time_tb_i = 0.0, time_tb_ii = 0.0;
+static double time_m21 = 0.0, time_m31 = 0.0; 
+static double time_a21 = 0.0, time_a31 = 0.0;
+static double time_b21 = 0.0, time_b31 = 0.0;
 
 
 void ble_wait_for_connection() {
@@ -84,33 +161,53 @@ void ble_wait_for_connection() {
 	sit_set_led(3, 1);
 }
 
+bool is_autostart() {
+	#ifdef CONFIG_SIT_SETTINGS
+		return sit_settings_autostart();
+	#else
+		return false;
+	#endif
+}
+
 void ble_start_connection() {
-	ble_start_advertising();
+	#ifndef CONFIG_SIT_FAST_BOOT
+		// with fast boot the advertising is started when BLE is ready
+		ble_start_advertising();
+	#endif
+	if (is_autostart()) {
+		// stored settings, the phone is not needed to start ranging
+		device_settings.state = measurement;
+		return;
+	}
 	ble_wait_for_connection();
 }
 
 void reset_sequence() {
-	sequence = 0;
-	measurements = 0;
+	initiator_session = (sit_session_t){0};
+	responder_session = (sit_session_t){0};
+	calibration_session = (sit_session_t){0};
 }
 
-void send_twr_notify(uint8_t responder) {
-	if (distance >= 0.0) {
+void send_twr_notify(sit_session_t *session, sit_addr_t responder) {
+	#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+		sit_diagnostic_classify(&diagnostic);
+	#endif
+	if (session->distance >= 0.0) {
 		LOG_INF("Responder: %d", responder);
 		json_distance_msg_all_t distance_notify = {
 			.header = {
 				.type = "distance_msg",
 				.state = "running",
 				.responder = responder,
-				.sequence = sequence,
-				.measurements = measurements,
+				.sequence = session->sequence,
+				.measurements = session->measurements,
 			},
 			.data = {
-				.distance = distance,
-				.time_round_1 = (float)(time_round_1 * DWT_TIME_UNITS),
-				.time_round_2 = (float)(time_round_2 * DWT_TIME_UNITS),
-				.time_reply_1 = (float)(time_reply_1 * DWT_TIME_UNITS),
-				.time_reply_2 = (float)(time_reply_2 * DWT_TIME_UNITS),
+				.distance = session->distance,
+				.time_round_1 = (float)(session->time_round_1 * DWT_TIME_UNITS),
+				.time_round_2 = (float)(session->time_round_2 * DWT_TIME_UNITS),
+				.time_reply_1 = (float)(session->time_reply_1 * DWT_TIME_UNITS),
+				.time_reply_2 = (float)(session->time_reply_2 * DWT_TIME_UNITS),
 			}, 
 			.diagnostic = {
 				.rssi_index_resp = diagnostic.rssi,
@@ -120,9 +217,9 @@ void send_twr_notify(uint8_t responder) {
 			}
 		};
 		ble_sit_notify(&distance_notify, sizeof(distance_notify));
-		measurements++;
-		LOG_INF("Test Measurement: %d von %d", measurements, device_settings.max_measurement);
-		if(device_settings.max_measurement != 0 && device_settings.max_measurement <= measurements) {
+		session->measurements++;
+		LOG_INF("Test Measurement: %d von %d", session->measurements, device_settings.max_measurement);
+		if(device_settings.max_measurement != 0 && device_settings.max_measurement <= session->measurements) {
 			device_settings.state = sleep;
 		}
 	}
@@ -132,8 +229,8 @@ void send_two_device_notify() {
 	json_simple_td_msg_t distance_notify = {
 		.header = {
 			.type = "cali_msg",
-			.sequence = sequence,
-			.measurements = measurements,
+			.sequence = calibration_session.sequence,
+			.measurements = calibration_session.measurements,
 		},
 		.data = {
 			.time_m21 = (float)(time_m21 * DWT_TIME_UNITS),
@@ -146,218 +243,1068 @@ void send_two_device_notify() {
 			.time_tc_ii = (float)(time_tc_ii * DWT_TIME_UNITS),
 			.time_tb_i = (float)(time_tb_i * DWT_TIME_UNITS),
 			.time_tb_ii = (float)(time_tb_ii * DWT_TIME_UNITS),
-			.time_round_1 = (float)(time_round_1 * DWT_TIME_UNITS),
-			.time_round_2 = (float)(time_round_2 * DWT_TIME_UNITS),
-			.time_reply_1 = (float)(time_reply_1 * DWT_TIME_UNITS),
-			.time_reply_2 = (float)(time_reply_2 * DWT_TIME_UNITS),
-			.distance = (float)distance,
+			.time_round_1 = (float)(calibration_session.time_round_1 * DWT_TIME_UNITS),
+			.time_round_2 = (float)(calibration_session.time_round_2 * DWT_TIME_UNITS),
+			.time_reply_1 = (float)(calibration_session.time_reply_1 * DWT_TIME_UNITS),
+			.time_reply_2 = (float)(calibration_session.time_reply_2 * DWT_TIME_UNITS),
+			.distance = (float)calibration_session.distance,
 			.dummy = 0,
 		}
 	};
 	ble_sit_td_notify(&distance_notify, sizeof(distance_notify));
-	measurements++;
-	if(device_settings.max_measurement != 0 && device_settings.max_measurement <= measurements) {
+	calibration_session.measurements++;
+	if(device_settings.max_measurement != 0 && device_settings.max_measurement <= calibration_session.measurements) {
+		device_settings.state = sleep;
+	}
+}
+
+#ifdef CONFIG_SIT_POSITION
+/* 
+ * Position and link index of an anchor, in the order of the setup. False 
+ * for an address without a provisioned anchor slot.
+ */
+bool anchor_index(sit_addr_t responder_id, uint8_t *index) {
+	if (responder_id < ANCHOR_BASE_ID || responder_id - ANCHOR_BASE_ID >= SIT_POSITION_MAX_ANCHORS) {
+		return false;
+	}
+	*index = (uint8_t)(responder_id - ANCHOR_BASE_ID);
+	return true;
+}
+
+/* Distance of the last exchange with prior (0..1) for the position engine */
+void update_position_distance(sit_addr_t responder_id, float prior) {
+	uint8_t index;
+	if (anchor_index(responder_id, &index)) {
+		sit_position_set_distance(index, 
+			(float)initiator_session.distance, initiator_session.sequence);
+		sit_position_set_prior(index, prior);
+	}
+}
+
+void send_position_notify() {
+	sit_position_t position;
+	if (!sit_position_fix(initiator_session.sequence, &position)) {
+		return;
+	}
+	LOG_INF("Position: %3.2f %3.2f %3.2f (RMS %3.2f)", 
+		position.x, position.y, position.z, position.quality);
+	json_position_msg_t position_notify = {
+		.header = {
+			.type = "position_msg",
+			.sequence = initiator_session.sequence,
+			.measurements = initiator_session.measurements,
+		},
+		.data = {
+			.x = position.x,
+			.y = position.y,
+			.z = position.z,
+			.quality = position.quality,
+			.anchors = position.anchors,
+			.iterations = position.iterations,
+		}
+	};
+	ble_sit_position_notify(&position_notify, sizeof(position_notify));
+	initiator_session.measurements++;
+	if(device_settings.max_measurement != 0 && device_settings.max_measurement <= initiator_session.measurements) {
 		device_settings.state = sleep;
 	}
 }
+#endif
+
+#ifdef CONFIG_SIT_ANCHOR_SELECT
+static float anchor_link_quality[SIT_POSITION_MAX_ANCHORS];
+static bool anchor_selected[SIT_POSITION_MAX_ANCHORS];
+
+void reset_anchor_selection() {
+	for (uint8_t i = 0; i < SIT_POSITION_MAX_ANCHORS; i++) {
+		anchor_link_quality[i] = 1.0f;
+		anchor_selected[i] = true;
+	}
+}
+
+/**
+ * Select the anchors for the next cycle. Every 
+ * CONFIG_SIT_ANCHOR_SELECT_FULL_CYCLE cycles and without a valid position 
+ * all anchors are used, so the link quality of every anchor stays fresh.
+ */
+void select_anchors() {
+	sit_position_t position;
+	if (initiator_session.sequence % CONFIG_SIT_ANCHOR_SELECT_FULL_CYCLE == 0 || !sit_position_last(&position)) {
+		for (uint8_t i = 0; i < SIT_POSITION_MAX_ANCHORS; i++) {
+			anchor_selected[i] = true;
+		}
+		return;
+	}
+	sit_vec3_t anchors[SIT_POSITION_MAX_ANCHORS];
+	float quality[SIT_POSITION_MAX_ANCHORS];
+	uint8_t selected[SIT_POSITION_MAX_ANCHORS];
+	for (uint8_t i = 0; i < SIT_POSITION_MAX_ANCHORS; i++) {
+		quality[i] = sit_position_get_anchor(i, &anchors[i]) ? anchor_link_quality[i] : 0.0f;
+		anchor_selected[i] = false;
+	}
+	sit_vec3_t estimate = {position.x, position.y, position.z};
+	uint8_t count = sit_anchor_select(anchors, quality, SIT_POSITION_MAX_ANCHORS, &estimate,
+			IS_ENABLED(CONFIG_SIT_POSITION_3D), CONFIG_SIT_ANCHOR_SELECT_K, selected);
+	for (uint8_t i = 0; i < count; i++) {
+		anchor_selected[selected[i]] = true;
+	}
+}
+
+bool is_anchor_selected(sit_addr_t responder_id) {
+	uint8_t index;
+	return anchor_index(responder_id, &index) && anchor_selected[index];
+}
+
+/**
+ * Drop the anchors which are not selected from the poll list, so the retry 
+ * budget only counts the anchors that are still polled in this cycle.
+ */
+uint16_t keep_selected_anchors(sit_addr_t *responder_ids, uint16_t responders) {
+	uint16_t selected = 0;
+	for (uint16_t i = 0; i < responders; i++) {
+		if (is_anchor_selected(responder_ids[i])) {
+			responder_ids[selected++] = responder_ids[i];
+		}
+	}
+	return selected;
+}
+
+void update_anchor_link(sit_addr_t responder_id, bool success) {
+	uint8_t index;
+	if (anchor_index(responder_id, &index)) {
+		sit_anchor_link_update(&anchor_link_quality[index], success, success ? diagnostic.nlos : 0);
+	}
+}
+#endif
+
+#ifdef CONFIG_SIT_XTAL_TRIM
+static sit_xtal_t xtal;
+
+/* Clock offset to the reference anchor after a good response */
+void update_xtal_trim(sit_addr_t responder_id) {
+	if (responder_id != CONFIG_SIT_XTAL_REFERENCE) {
+		return;
+	}
+	double hz_to_ppm = sit_device_config.chan == 5 ? 
+		HERTZ_TO_PPM_MULTIPLIER_CHAN_5 : HERTZ_TO_PPM_MULTIPLIER_CHAN_9;
+	float offset_ppm = (float)(dwt_readcarrierintegrator() * FREQ_OFFSET_MULTIPLIER * hz_to_ppm);
+	bool was_converged = xtal.converged;
+	if (sit_xtal_update(&xtal, offset_ppm)) {
+		dwt_setxtaltrim(xtal.trim);
+		LOG_INF("XTAL trim 0x%02x (offset %.2f ppm)", xtal.trim, (double)xtal.last_mean);
+	}
+	if (xtal.converged && !was_converged) {
+		LOG_INF("XTAL trim converged: 0x%02x", xtal.trim);
+		if (device_settings.xtal_trim != xtal.trim) {
+			set_xtal_trim(xtal.trim);
+		}
+	}
+}
+#endif
+
+/* Side by side statistics of SS-TWR and DS-TWR */
+typedef struct {
+	const char *name;
+	uint32_t exchanges;
+	uint32_t failures;
+	uint64_t exchange_us;
+	double mean;
+	double m2;
+} twr_stats_t;
+
+static twr_stats_t ss_twr_stats = {.name = "SS-TWR"};
+static twr_stats_t ds_twr_stats = {.name = "DS-TWR"};
+
+void update_twr_stats(twr_stats_t *stats, const sit_session_t *session, bool success, uint32_t start_cycles) {
+	stats->exchanges++;
+	stats->exchange_us += k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+	if (!success) {
+		stats->failures++;
+	} else {
+		// Welford, the spread of a static setup is the precision of the mode
+		uint32_t n = stats->exchanges - stats->failures;
+		double delta = session->distance - stats->mean;
+		stats->mean += delta / n;
+		stats->m2 += delta * (session->distance - stats->mean);
+	}
+	if (stats->exchanges < TWR_STATS_REPORT) {
+		return;
+	}
+	uint32_t ranges = stats->exchanges - stats->failures;
+	uint32_t exchange_us = (uint32_t)(stats->exchange_us / stats->exchanges);
+	LOG_INF("%s: %u/%u ranges, exchange %u us (max %u ranges/s), mean %.3f m, std %.1f mm",
+		stats->name, ranges, stats->exchanges, exchange_us, 1000000 / MAX(exchange_us, 1),
+		stats->mean, ranges > 1 ? sqrt(stats->m2 / (ranges - 1)) * 1000 : 0.0);
+	const char *name = stats->name;
+	*stats = (twr_stats_t){.name = name};
+}
+
+#ifdef CONFIG_SIT_RANGE_BIAS
+/* Bias for the signal level of the last received message (response or final) */
+double correct_range_bias(double raw_distance) {
+	bool prf_64 = sit_device_config.rxCode > 8;
+	int32_t distance_mm = sit_range_bias_correct_mm(
+		(int32_t)(raw_distance * 1000),
+		sit_device_config.chan,
+		prf_64,
+		(int32_t)(diagnostic.rssi * 256));
+	return (double)distance_mm / 1000;
+}
+#endif
+
+/* SS-TWR exchange without the statistics and the XTAL trim, also used for the anchor checks */
+bool sstwr_exchange(sit_session_t *session, sit_addr_t responder_id) {
+	sit_set_rx_after_tx_delay(SS_POLL_TX_TO_RESP_RX_DLY_UUS);
+	sit_set_rx_timeout(SS_RESP_RX_TIMEOUT_UUS);
+	sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
+
+	msg_simple_t twr_poll = {{ss_twr_1_poll, (uint16_t)session->sequence, device_settings.deviceID, responder_id}, 0};
+	if (!sit_start_poll_cca((uint8_t*) &twr_poll, (uint16_t)sizeof(twr_poll))) {
+		return false;
+	}
+
+	msg_ss_twr_final_t rx_final_msg;
+	msg_id_t msg_id = ss_twr_2_resp;
+	if(!sit_check_final_msg_id(msg_id, &rx_final_msg) || rx_final_msg.header.source != responder_id
+			|| rx_final_msg.header.sequence != (uint16_t)session->sequence) {
+		LOG_WRN("Something is wrong with SS-TWR Resp Msg");
+		dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+		#ifdef CONFIG_SIT_CCA
+			sit_cca_result(false);
+		#endif
+		return false;
+	}
+	#ifdef CONFIG_SIT_CCA
+		sit_cca_result(true);
+	#endif
+	uint64_t poll_tx_ts = get_tx_timestamp_u64();
+	uint64_t resp_rx_ts = get_rx_timestamp_u64();
+	uint64_t poll_rx_ts = get_timestamp_u40(rx_final_msg.poll_rx_ts);
+	uint64_t resp_tx_ts = get_timestamp_u40(rx_final_msg.resp_tx_ts);
+
+	// positive ratio: the clock of the responder is faster
+	double hz_to_ppm = sit_device_config.chan == 5 ? 
+		HERTZ_TO_PPM_MULTIPLIER_CHAN_5 : HERTZ_TO_PPM_MULTIPLIER_CHAN_9;
+	double clockOffsetRatio = dwt_readcarrierintegrator() * (FREQ_OFFSET_MULTIPLIER * hz_to_ppm / 1.0e6);
+	session->clock_offset = clockOffsetRatio;
+
+	// 40 bit counters, the differences are taken modulo 2^40
+	session->time_round_1 = (double)((resp_rx_ts - poll_tx_ts) & TIMESTAMP_U40_MASK);
+	session->time_reply_1 = (double)((resp_tx_ts - poll_rx_ts) & TIMESTAMP_U40_MASK);
+	session->time_round_2 = 0.0;
+	session->time_reply_2 = 0.0;
+
+	double tof = ((session->time_round_1 - session->time_reply_1 * (1 - clockOffsetRatio)) / 2.0) * DWT_TIME_UNITS;
+	session->distance = tof * SPEED_OF_LIGHT;
+	#ifdef CONFIG_SIT_RANGE_BIAS
+		session->distance = correct_range_bias(session->distance);
+	#endif
+	LOG_INF("initiator -> responder Distance: %3.2lf", session->distance);
+	return true;
+}
+
+bool sit_sstwr_poll(sit_session_t *session, sit_addr_t responder_id) {
+	uint32_t start_cycles = k_cycle_get_32();
+	bool success = sstwr_exchange(session, responder_id);
+	update_twr_stats(&ss_twr_stats, session, success, start_cycles);
+	if (!success) {
+		return false;
+	}
+	#ifdef CONFIG_SIT_XTAL_TRIM
+		// the carrier integrator still holds the offset of the response
+		update_xtal_trim(responder_id);
+	#endif
+	sit_boot_mark(boot_first_range);
+	return true;
+}
+
+bool sit_sstwr_response(msg_simple_t *rx_poll_msg) {
+	uint64_t poll_rx_ts = get_rx_timestamp_u64();
+	uint32_t resp_tx_time = (poll_rx_ts + ((uint64_t)CONFIG_SIT_SSTWR_REPLY_UUS * UUS_TO_DWT_TIME)) >> 8;
+	// the TX timestamp is known before the frame is sent: delayed TX time + antenna delay
+	uint64_t resp_tx_ts = ((((uint64_t)(resp_tx_time & 0xFFFFFFFEUL)) << 8) + get_tx_ant_dly()) 
+		& TIMESTAMP_U40_MASK;
+
+	msg_ss_twr_final_t resp_msg = {{
+			ss_twr_2_resp,
+			rx_poll_msg->header.sequence,
+			device_settings.deviceID, 
+			rx_poll_msg->header.source},
+		};
+	set_timestamp_u40(resp_msg.poll_rx_ts, poll_rx_ts);
+	set_timestamp_u40(resp_msg.resp_tx_ts, resp_tx_ts);
+	if (!sit_send_at((uint8_t*)&resp_msg, sizeof(msg_ss_twr_final_t), resp_tx_time)) {
+		LOG_WRN("Something is wrong with Sending SS-TWR Resp Msg");
+		return false;
+	}
+	return true;
+}
+
+#ifdef CONFIG_SIT_DISCOVERY
+#define MAX_RESPONDERS SIT_RESPONDER_TABLE_SIZE
+#else
+/* fixed anchor ids, larger deployments use the discovery */
+#define MAX_RESPONDERS (UINT8_MAX - ANCHOR_BASE_ID + 1)
+#endif
+
+/* Responders of this cycle: the discovered anchors or 100..device_settings.responder */
+uint16_t get_responders(sit_addr_t *responder_ids) {
+	#ifdef CONFIG_SIT_DISCOVERY
+		return sit_discovery_responders(responder_ids);
+	#else
+		uint16_t count = 0;
+		for (sit_addr_t responder_id = ANCHOR_BASE_ID; responder_id <= device_settings.responder && count < MAX_RESPONDERS; responder_id++) {
+			responder_ids[count++] = responder_id;
+		}
+		return count;
+	#endif
+}
+
+typedef bool (*twr_poll_t)(sit_session_t *session, sit_addr_t responder_id);
+
+#ifdef CONFIG_SIT_RETRY
+#define RETRY_REPORT_CYCLES 100
+
+static sit_retry_stats_t retry_stats;
+
+/* Time left for retries in this cycle, with the superframe until the end of the own slot */
+uint32_t retry_remaining_us(int64_t cycle_start) {
+	#ifdef CONFIG_SIT_SLOTS
+		ARG_UNUSED(cycle_start);
+		return sit_slots_remaining_us();
+	#else
+		int64_t remaining_ms = cycle_start + CONFIG_SIT_RETRY_BUDGET_MS - k_uptime_get();
+		return remaining_ms > 0 ? (uint32_t)remaining_ms * 1000 : 0;
+	#endif
+}
+#endif
+
+/* 
+ * Poll a responder, with CONFIG_SIT_RETRY a failed exchange is repeated at 
+ * once while the time left covers the retry and the responders not polled yet.
+ */
+bool poll_responder(twr_poll_t poll, sit_addr_t responder_id, int64_t cycle_start, uint16_t responders_left) {
+	#ifdef CONFIG_SIT_RETRY
+		uint8_t attempts = 0;
+		uint32_t exchange_us;
+		bool success;
+		do {
+			uint32_t start_cycles = k_cycle_get_32();
+			attempts++;
+			success = poll(&initiator_session, responder_id);
+			exchange_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+		} while (!success && sit_retry_allowed(attempts, exchange_us, retry_remaining_us(cycle_start), responders_left));
+		int16_t index = sit_retry_record(&retry_stats, responder_id, attempts, success);
+		if (index >= 0 && retry_stats.cycles[index] % RETRY_REPORT_CYCLES == 0) {
+			LOG_INF("Responder %u: %u/%u cycles with range, %u retries, %u recovered", responder_id,
+				retry_stats.ranges[index], retry_stats.cycles[index], 
+				retry_stats.retries[index], retry_stats.recovered[index]);
+		}
+		return success;
+	#else
+		ARG_UNUSED(cycle_start);
+		ARG_UNUSED(responders_left);
+		return poll(&initiator_session, responder_id);
+	#endif
+}
+
+/* With the superframe the tag starts in its own slot */
+void initiator_start() {
+	#ifdef CONFIG_SIT_RETRY
+		sit_retry_reset(&retry_stats);
+	#endif
+	#ifdef CONFIG_SIT_SLOTS
+		sit_slots_reset();
+		sit_slots_wait();
+	#endif
+}
+
+void initiator_stop() {
+	#ifdef CONFIG_SIT_SLOTS
+		sit_slots_release();
+	#endif
+}
+
+/* Wait for the next cycle, with discovery the receiver listens for beacons first */
+void initiator_wait(int64_t cycle_start) {
+	#ifdef CONFIG_SIT_DISCOVERY
+		sit_discovery_listen();
+	#endif
+	#ifdef CONFIG_SIT_SLOTS
+		ARG_UNUSED(cycle_start);
+		sit_slots_wait();
+	#elif defined(CONFIG_SIT_POWER_SLEEP)
+		sit_power_duty_cycle(cycle_start, TWR_PERIOD_MS);
+	#elif defined(CONFIG_SIT_DISCOVERY)
+		// the beacon listen time is part of the period
+		ARG_UNUSED(cycle_start);
+		k_msleep(TWR_PERIOD_MS - CONFIG_SIT_DISCOVERY_LISTEN_MS);
+	#else
+		ARG_UNUSED(cycle_start);
+		k_msleep(TWR_PERIOD_MS);
+	#endif
+}
 
 void sit_sstwr_initiator() {
+	#ifdef CONFIG_SIT_ANCHOR_SELECT
+		reset_anchor_selection();
+	#endif
+	initiator_start();
 	while(device_settings.state == measurement) {
-		sit_set_rx_after_tx_delay(DS_RESP_TX_TO_FINAL_RX_DLY_UUS);
-		sit_set_rx_timeout(DS_FINAL_RX_TIMEOUT+2000);
-		sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
-		for(uint8_t responder_id=100; responder_id<=device_settings.responder; responder_id++) {
-			msg_simple_t twr_poll = {{twr_1_poll, (uint8_t)sequence, device_settings.deviceID, responder_id}, 0};
-			sit_start_poll((uint8_t*) &twr_poll, (uint16_t)sizeof(twr_poll));
-
-			msg_ss_twr_final_t rx_final_msg;
-			msg_id_t msg_id = ss_twr_2_resp;
-			if(sit_check_final_msg_id(msg_id, &rx_final_msg)) {
-				uint64_t poll_tx_ts = get_tx_timestamp_u64();
-				uint64_t resp_rx_ts = get_rx_timestamp_u64();
-				
-				uint64_t poll_rx_ts = rx_final_msg.poll_rx_ts;
-				uint64_t resp_tx_ts = rx_final_msg.resp_tx_ts;
-
-				double clockOffsetRatio = dwt_readcarrierintegrator() * 
-						(FREQ_OFFSET_MULTIPLIER * HERTZ_TO_PPM_MULTIPLIER_CHAN_9 / 1.0e6) ;
-
-				time_round_1 = (double)(resp_rx_ts - poll_tx_ts);
-				time_reply_1 = (double)(resp_tx_ts - poll_rx_ts);
-
-				double tof =  ((time_round_1 - time_reply_1 * 
-						(1 - clockOffsetRatio)) / 2.0) * DWT_TIME_UNITS;
-				
-				distance = tof * SPEED_OF_LIGHT;
-
-				LOG_INF("TX Power: 0x%08x", (int32_t) 0xfe);
-				LOG_INF("initiator -> responder Distance: %3.2lf \n", distance);
-				send_twr_notify(responder_id);
-			} else {
-				LOG_WRN("Something is wrong");
-				dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
-			}
+		int64_t cycle_start = k_uptime_get();
+		#ifdef CONFIG_SIT_ANCHOR_SELECT
+			select_anchors();
+		#endif
+		sit_addr_t responder_ids[MAX_RESPONDERS];
+		uint16_t responders = get_responders(responder_ids);
+		#ifdef CONFIG_SIT_ANCHOR_SELECT
+			responders = keep_selected_anchors(responder_ids, responders);
+		#endif
+		for(uint16_t i = 0; i < responders; i++) {
+			sit_addr_t responder_id = responder_ids[i];
+			bool success = poll_responder(sit_sstwr_poll, responder_id, cycle_start, responders - i - 1);
+			#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+				// the anchor selection and the position prior use the NLOS probability
+				sit_diagnostic_classify(&diagnostic);
+			#endif
+			#ifdef CONFIG_SIT_POSITION
+				if (success) {
+					#if defined(CONFIG_SIT_POSITION_RANSAC) && defined(CONFIG_SIT_DIAGNOSTIC)
+						update_position_distance(responder_id, 
+							sit_position_prior(diagnostic.nlos, diagnostic.rssi, diagnostic.fpi));
+					#else
+						update_position_distance(responder_id, 1.0f);
+					#endif
+				}
+			#else
+				if (success) {
+					send_twr_notify(&initiator_session, responder_id);
+				}
+			#endif
+			#ifdef CONFIG_SIT_ANCHOR_SELECT
+				update_anchor_link(responder_id, success);
+			#endif
+			#ifdef CONFIG_SIT_DISCOVERY
+				sit_discovery_update(responder_id, success, 
+					success ? initiator_session.distance : -1.0, initiator_session.clock_offset);
+			#endif
 		}
-		sequence++;
-		k_msleep(100);
+		#ifdef CONFIG_SIT_POSITION
+			send_position_notify();
+		#endif
+		initiator_session.sequence++;
+		#ifdef CONFIG_SIT_TEMP_COMP
+			sit_temp_service(TWR_PERIOD_MS - (k_uptime_get() - cycle_start));
+		#endif
+		initiator_wait(cycle_start);
 	}
+	initiator_stop();
 }
 
-void sit_sstwr_responder() {
-	while(device_settings.state == measurement) {
-		sit_receive_now(0,0);
-		msg_simple_t rx_poll_msg;
-		msg_id_t msg_id = twr_1_poll;
-		if(sit_check_msg_id(msg_id, &rx_poll_msg)){
-			uint64_t poll_rx_ts = get_rx_timestamp_u64();
-			
-			uint32_t resp_tx_time = (poll_rx_ts + (1800 * UUS_TO_DWT_TIME)) >> 8;
-
-			uint16_t tx_dly = get_tx_ant_dly();
-			LOG_INF("TX Antenna Delay: %d", tx_dly);
-			uint32_t resp_tx_ts = (((uint64_t)(resp_tx_time & 0xFFFFFFFEUL)) << 8) + tx_dly;
-			
-			msg_ss_twr_final_t msg_ss_twr_final_t = {{
-					ss_twr_2_resp,
-					(uint8_t)(rx_poll_msg.header.sequence),
-					device_settings.deviceID, 
-					rx_poll_msg.header.source},
-					(uint32_t)poll_rx_ts, 
-					resp_tx_ts,
-					0
-				};
-			sit_send_at((uint8_t*)&msg_ss_twr_final_t, sizeof(msg_ss_twr_final_t), resp_tx_time);
+bool sit_dstwr_poll(sit_session_t *session, sit_addr_t responder_id) {
+	sit_set_rx_after_tx_delay(DS_POLL_TX_TO_RESP_RX_DLY_UUS);
+	sit_set_rx_timeout(DS_RESP_RX_TIMEOUT_UUS+2000);
+	sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
 
-		} else {
-			LOG_WRN("Something is wrong");
-			dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+	msg_simple_t twr_poll = {{twr_1_poll, (uint16_t)session->sequence, device_settings.deviceID , responder_id},0};
+	if (!sit_start_poll_cca((uint8_t*) &twr_poll, (uint16_t)sizeof(twr_poll))) {
+		return false;
+	}
+
+	msg_simple_t rx_resp_msg;
+	msg_id_t msg_id = ds_twr_2_resp;
+
+	bool response = sit_check_msg_id(msg_id, &rx_resp_msg) && rx_resp_msg.header.source == responder_id
+			&& rx_resp_msg.header.sequence == (uint16_t)session->sequence;
+	#ifdef CONFIG_SIT_CCA
+		sit_cca_result(response);
+	#endif
+	if(response) {
+		uint64_t poll_tx_ts = get_tx_timestamp_u64();
+		uint64_t resp_rx_ts = get_rx_timestamp_u64();
+		double hz_to_ppm = sit_device_config.chan == 5 ? 
+			HERTZ_TO_PPM_MULTIPLIER_CHAN_5 : HERTZ_TO_PPM_MULTIPLIER_CHAN_9;
+		session->clock_offset = dwt_readcarrierintegrator() * (FREQ_OFFSET_MULTIPLIER * hz_to_ppm / 1.0e6);
+		#ifdef CONFIG_SIT_XTAL_TRIM
+			update_xtal_trim(responder_id);
+		#endif
+		
+		uint32_t final_tx_time = (resp_rx_ts + (1800 * UUS_TO_DWT_TIME)) >> 8;
+		uint64_t final_tx_ts = (((uint64_t)(final_tx_time & 0xFFFFFFFEUL)) << 8) + get_tx_ant_dly();
+
+		msg_ds_twr_final_t final_msg = {{
+			ds_twr_3_final,
+			rx_resp_msg.header.sequence,
+			rx_resp_msg.header.dest,
+			rx_resp_msg.header.source},
+			(uint32_t)poll_tx_ts,
+			(uint32_t)resp_rx_ts,
+			(uint32_t)final_tx_ts,
+			0
+		};
+
+		#ifdef CONFIG_SIT_POSITION
+			// the responder sends the distance back right after the final
+			sit_set_rx_after_tx_delay(0);
+			sit_set_rx_timeout(DS_REPORT_RX_TIMEOUT_UUS);
+			sit_set_preamble_detection_timeout(0);
+			bool ret = sit_send_at_with_response((uint8_t*)&final_msg, sizeof(msg_ds_twr_final_t),final_tx_time);
+		#else
+			bool ret = sit_send_at((uint8_t*)&final_msg, sizeof(msg_ds_twr_final_t),final_tx_time);
+		#endif
+
+		if (ret == false) {
+			LOG_WRN("Something is wrong with Sending Final Msg");
+			return false;
 		}
-		k_msleep(90);
+		#ifdef CONFIG_SIT_POSITION
+			msg_ds_twr_report_t report_msg;
+			if (!sit_check_ds_report_msg_id(ds_twr_4_report, &report_msg) 
+					|| report_msg.header.source != responder_id
+					|| report_msg.header.sequence != (uint16_t)session->sequence) {
+				LOG_WRN("Something is wrong with Receiving Report Msg");
+				dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+				return false;
+			}
+			session->distance = (double)report_msg.distance_mm / 1000.0;
+		#endif
+		// the final is sent, the initiator side of the exchange is done
+		sit_boot_mark(boot_first_range);
+		return true;
+	} else {
+		LOG_WRN("Something is wrong with Receiving Msg");
+		dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+		return false;
+	}
+}
+
+bool sit_dstwr_response(sit_session_t *session, msg_simple_t *rx_poll_msg) {
+	uint32_t start_cycles = k_cycle_get_32();
+	uint64_t poll_rx_ts = get_rx_timestamp_u64();
+		
+	uint32_t resp_tx_time = (poll_rx_ts + (1800 * UUS_TO_DWT_TIME)) >> 8;
+	
+	msg_simple_t msg_ds_poll_resp = {{
+			ds_twr_2_resp,
+			rx_poll_msg->header.sequence,
+			rx_poll_msg->header.dest,
+			rx_poll_msg->header.source,
+		},0};
+	sit_set_rx_after_tx_delay(DS_RESP_TX_TO_FINAL_RX_DLY_UUS);
+	sit_set_rx_timeout(DS_FINAL_RX_TIMEOUT+2000);
+	sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
+	bool ret = sit_send_at_with_response((uint8_t*)&msg_ds_poll_resp, sizeof(msg_simple_t), resp_tx_time);
+	if (ret == false) {
+		LOG_WRN("Something is wrong with Sending Poll Resp Msg");
+		return false;
+	}
+	msg_ds_twr_final_t rx_ds_final_msg;
+	msg_id_t msg_id = ds_twr_3_final;
+	bool final_received = sit_check_ds_final_msg_id(msg_id, &rx_ds_final_msg);
+	if(final_received && rx_ds_final_msg.header.dest == device_settings.deviceID
+			&& rx_ds_final_msg.header.source == rx_poll_msg->header.source){
+		uint64_t resp_tx_ts = get_tx_timestamp_u64();
+		uint64_t final_rx_ts = get_rx_timestamp_u64();
+
+		uint32_t poll_tx_ts = rx_ds_final_msg.poll_tx_ts;
+		uint32_t resp_rx_ts = rx_ds_final_msg.resp_rx_ts;
+		uint32_t final_tx_ts = rx_ds_final_msg.final_tx_ts;
+
+		uint32_t poll_rx_ts_32, resp_tx_ts_32, final_rx_ts_32;
+		poll_rx_ts_32 = (uint32_t) poll_rx_ts;
+		resp_tx_ts_32 = (uint32_t) resp_tx_ts;
+		final_rx_ts_32 = (uint32_t) final_rx_ts;
+
+		int64_t tof_dtu;
+		session->time_round_1 = (double)(resp_rx_ts - poll_tx_ts);
+		session->time_round_2 = (double)(final_rx_ts_32 - resp_tx_ts_32);
+		session->time_reply_1 = (double)(resp_tx_ts_32 - poll_rx_ts_32);
+		session->time_reply_2 = (double)(final_tx_ts - resp_rx_ts);
+		tof_dtu = (int64_t)((session->time_round_1 * session->time_round_2 
+								- session->time_reply_1 * session->time_reply_2) 
+								/ (session->time_round_1 + session->time_round_2 
+								+ session->time_reply_1 + session->time_reply_2)
+							);
+
+		double tof = (double)tof_dtu * DWT_TIME_UNITS;
+		session->distance = tof * SPEED_OF_LIGHT;
+		#ifdef CONFIG_SIT_RANGE_BIAS
+			session->distance = correct_range_bias(session->distance);
+		#endif
+		LOG_INF("Distance: %lf", session->distance);
+		update_twr_stats(&ds_twr_stats, session, true, start_cycles);
+		#ifdef CONFIG_SIT_POSITION
+			// tags with the position engine wait for the distance
+			msg_ds_twr_report_t report_msg = {{
+				ds_twr_4_report,
+				rx_ds_final_msg.header.sequence,
+				device_settings.deviceID,
+				rx_ds_final_msg.header.source},
+				(int32_t)(session->distance * 1000.0),
+				0
+			};
+			sit_send_now((uint8_t*)&report_msg, sizeof(msg_ds_twr_report_t));
+		#endif
+		sit_boot_mark(boot_first_range);
+		return true;
+	} else {
+		LOG_WRN("Something is wrong with Final Msg Receive");
+		#ifdef CONFIG_SIT_SLOTS
+			if (final_received) {
+				sit_slots_collision();
+			}
+		#endif
+		dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+		update_twr_stats(&ds_twr_stats, session, false, start_cycles);
+		return false;
 	}
 }
 
 void sit_dstwr_initiator() {
+	initiator_start();
 	while(device_settings.state == measurement) {
-		for(uint8_t responder_id=100; responder_id<=device_settings.responder; responder_id++) {
-			sit_set_rx_after_tx_delay(DS_POLL_TX_TO_RESP_RX_DLY_UUS);
-			sit_set_rx_timeout(DS_RESP_RX_TIMEOUT_UUS+2000);
-			sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
-
-			msg_simple_t twr_poll = {{twr_1_poll, sequence, device_settings.deviceID , responder_id},0};
-			sit_start_poll((uint8_t*) &twr_poll, (uint16_t)sizeof(twr_poll));
-
-			msg_simple_t rx_resp_msg;
-			msg_id_t msg_id = ds_twr_2_resp;
-
-			if(sit_check_msg_id(msg_id, &rx_resp_msg)) {
-				uint64_t poll_tx_ts = get_tx_timestamp_u64();
-				uint64_t resp_rx_ts = get_rx_timestamp_u64();
-				
-				uint32_t final_tx_time = (resp_rx_ts + (1800 * UUS_TO_DWT_TIME)) >> 8;
-				uint64_t final_tx_ts = (((uint64_t)(final_tx_time & 0xFFFFFFFEUL)) << 8) + get_tx_ant_dly();
-
-				msg_ds_twr_final_t final_msg = {{
-					ds_twr_3_final,
-					rx_resp_msg.header.sequence,
-					rx_resp_msg.header.dest,
-					rx_resp_msg.header.source},
-					(uint32_t)poll_tx_ts,
-					(uint32_t)resp_rx_ts,
-					(uint32_t)final_tx_ts,
-					0
-				};
-
-				bool ret = sit_send_at((uint8_t*)&final_msg, sizeof(msg_ds_twr_final_t),final_tx_time);
+		int64_t cycle_start = k_uptime_get();
+		sit_addr_t responder_ids[MAX_RESPONDERS];
+		uint16_t responders = get_responders(responder_ids);
+		for(uint16_t i = 0; i < responders; i++) {
+			bool success = poll_responder(sit_dstwr_poll, responder_ids[i], cycle_start, responders - i - 1);
+			#ifdef CONFIG_SIT_POSITION
+				if (success) {
+					// no CIR diagnostic at the initiator, every distance has the same prior
+					update_position_distance(responder_ids[i], 1.0f);
+				}
+			#endif
+			#ifdef CONFIG_SIT_DISCOVERY
+				// without the position engine the distance is only known at the responder
+				sit_discovery_update(responder_ids[i], success, 
+					IS_ENABLED(CONFIG_SIT_POSITION) && success ? initiator_session.distance : -1.0, 
+					initiator_session.clock_offset);
+			#else
+				ARG_UNUSED(success);
+			#endif
+		}
+		#ifdef CONFIG_SIT_POSITION
+			send_position_notify();
+		#endif
+		initiator_session.sequence++;
+		#ifdef CONFIG_SIT_TEMP_COMP
+			sit_temp_service(TWR_PERIOD_MS - (k_uptime_get() - cycle_start));
+		#endif
+		initiator_wait(cycle_start);
+	}
+	initiator_stop();
+}
 
-				if (ret == false) {
-					LOG_WRN("Something is wrong with Sending Final Msg");
-					continue;
+void sit_twr_compare_initiator() {
+	initiator_start();
+	while(device_settings.state == measurement) {
+		int64_t cycle_start = k_uptime_get();
+		sit_addr_t responder_ids[MAX_RESPONDERS];
+		uint16_t responders = get_responders(responder_ids);
+		for(uint16_t i = 0; i < responders; i++) {
+			sit_addr_t responder_id = responder_ids[i];
+			if (initiator_session.sequence % 2 == 0) {
+				if (poll_responder(sit_sstwr_poll, responder_id, cycle_start, responders - i - 1)) {
+					send_twr_notify(&initiator_session, responder_id);
 				}
 			} else {
-				LOG_WRN("Something is wrong with Receiving Msg");
-				dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+				poll_responder(sit_dstwr_poll, responder_id, cycle_start, responders - i - 1);
 			}
 		}
-		sequence++;
-		k_msleep(100);
+		initiator_session.sequence++;
+		initiator_wait(cycle_start);
 	}
+	initiator_stop();
 }
 
-void sit_dstwr_responder() {
-	while(device_settings.state == measurement) { 
+/* Receiver on until the next poll, in sniff mode if the responder is idle */
+void responder_receive() {
+	#ifdef CONFIG_SIT_SNIFF
+		sit_sniff_receive();
+	#elif defined(CONFIG_SIT_DISCOVERY) || defined(CONFIG_SIT_SLOTS)
+		uint32_t rx_timeout = 0;
+		#ifdef CONFIG_SIT_DISCOVERY
+			// timeout for the beacon if the anchor is not polled
+			rx_timeout = sit_discovery_rx_timeout();
+		#endif
+		#ifdef CONFIG_SIT_SLOTS
+			// the coordinator sends the superframe beacon in time
+			rx_timeout = sit_slots_rx_timeout(rx_timeout);
+		#endif
+		sit_receive_now(0, rx_timeout);
+	#else
 		sit_receive_now(0,0);
-		msg_simple_t rx_poll_msg;
-		msg_id_t msg_id = twr_1_poll;
-		if(sit_check_msg_id(msg_id, &rx_poll_msg) && rx_poll_msg.header.dest == device_settings.deviceID){
-			uint64_t poll_rx_ts = get_rx_timestamp_u64();
-				
-			uint32_t resp_tx_time = (poll_rx_ts + (1800 * UUS_TO_DWT_TIME)) >> 8;
-			
-			msg_simple_t msg_ds_poll_resp = {{
-					ds_twr_2_resp,
-					rx_poll_msg.header.sequence,
-					rx_poll_msg.header.dest,
-					rx_poll_msg.header.source,
-				},0};
-			sit_set_rx_after_tx_delay(DS_RESP_TX_TO_FINAL_RX_DLY_UUS);
-			sit_set_rx_timeout(DS_FINAL_RX_TIMEOUT+2000);
-			sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
-			bool ret = sit_send_at_with_response((uint8_t*)&msg_ds_poll_resp, sizeof(msg_simple_t), resp_tx_time);
-			if (ret == false) {
-				continue;
-				LOG_WRN("Something is wrong with Sending Poll Resp Msg");
-			}
-			msg_ds_twr_final_t rx_ds_final_msg;
-			msg_id = ds_twr_3_final;
-			if(sit_check_ds_final_msg_id(msg_id, &rx_ds_final_msg) && rx_ds_final_msg.header.dest == device_settings.deviceID){
-				uint64_t resp_tx_ts = get_tx_timestamp_u64();
-				uint64_t final_rx_ts = get_rx_timestamp_u64();
-
-				uint32_t poll_tx_ts = rx_ds_final_msg.poll_tx_ts;
-				uint32_t resp_rx_ts = rx_ds_final_msg.resp_rx_ts;
-				uint32_t final_tx_ts = rx_ds_final_msg.final_tx_ts;
-
-				uint32_t poll_rx_ts_32, resp_tx_ts_32, final_rx_ts_32;
-				poll_rx_ts_32 = (uint32_t) poll_rx_ts;
-				resp_tx_ts_32 = (uint32_t) resp_tx_ts;
-				final_rx_ts_32 = (uint32_t) final_rx_ts;
-
-				int64_t tof_dtu;
-				time_round_1 = (double)(resp_rx_ts - poll_tx_ts);
-				time_round_2 = (double)(final_rx_ts_32 - resp_tx_ts_32);
-				time_reply_1 = (double)(resp_tx_ts_32 - poll_rx_ts_32);
-				time_reply_2 = (double)(final_tx_ts - resp_rx_ts);
-				tof_dtu = (int64_t)((time_round_1 * time_round_2 - time_reply_1 * time_reply_2) 
-										/ (time_round_1 + time_round_2 + time_reply_1 + time_reply_2)
-									);
+	#endif
+}
 
-				double tof = (double)tof_dtu * DWT_TIME_UNITS;
-				distance = tof * SPEED_OF_LIGHT;
-				LOG_INF("Distance: %lf", distance);
-				
-				send_twr_notify(device_settings.deviceID);
-			} else {
-                LOG_WRN("Something is wrong with Final Msg Receive");
-                dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
-            }
+#ifdef CONFIG_SIT_RX_WINDOW
+#define RX_WINDOW_REPORT_POLLS 100
+
+static sit_rx_window_t rx_window;
+static uint64_t rx_window_on_dtu;
+static uint32_t rx_window_polls;
+static uint64_t rx_window_first_poll;
+
+/* 
+ * Open the receiver around the expected poll. The CPU sleeps until shortly
+ * before the window, the DW3000 enables the receiver at the window start.
+ * Returns false if the receiver is continuously on.
+ */
+bool open_rx_window() {
+	uint64_t start;
+	double length;
+	if (!sit_rx_window_next(&rx_window, &start, &length)) {
+		responder_receive();
+		return false;
+	}
+	uint32_t start_hi32 = (uint32_t)(start >> 8);
+	uint32_t wait_hi32 = start_hi32 - dwt_readsystimestamphi32();
+	// wait_hi32 is in 256 dtu (~4 ns), a negative value means the window is missed
+	if ((int32_t)wait_hi32 > 0) {
+		uint32_t wait_us = (uint32_t)(((uint64_t)wait_hi32 << 8) / UUS_TO_DWT_TIME);
+		if (wait_us > 2000) {
+			k_usleep(wait_us - 1000);
+		}
+	}
+	dwt_setdelayedtrxtime(start_hi32);
+	if (!sit_receive_at((uint32_t)(length / UUS_TO_DWT_TIME) + 1)) {
+		responder_receive();
+		return false;
+	}
+	rx_window_on_dtu += (uint64_t)length;
+	return true;
+}
 
+void update_rx_window(bool windowed, bool poll_received, uint64_t poll_rx_ts) {
+	if (!poll_received) {
+		if (windowed) {
+			sit_rx_window_miss(&rx_window);
+		}
+		return;
+	}
+	if (rx_window_polls == 0) {
+		rx_window_first_poll = poll_rx_ts;
+		rx_window_on_dtu = 0;
+	}
+	sit_rx_window_update(&rx_window, poll_rx_ts);
+	rx_window_polls++;
+	if (rx_window_polls % RX_WINDOW_REPORT_POLLS == 0) {
+		uint64_t elapsed = (poll_rx_ts - rx_window_first_poll) & SIT_RX_WINDOW_TIMESTAMP_MASK;
+		LOG_INF("RX window: guard %u us, rx on %u.%u%%",
+			(uint32_t)(sit_rx_window_guard(&rx_window) / UUS_TO_DWT_TIME),
+			(uint32_t)(rx_window_on_dtu * 100 / MAX(elapsed, 1)),
+			(uint32_t)(rx_window_on_dtu * 1000 / MAX(elapsed, 1) % 10));
+		rx_window_polls = 0;
+	}
+}
+#endif
+
+#ifdef CONFIG_SIT_HYBRID
+/* Tag polls arrive every TWR_PERIOD_MS, the receiver is on until shortly before the next one */
+#define HYBRID_LISTEN_MS (TWR_PERIOD_MS - 10)
+
+/* Answer SS-TWR polls of other anchors until the uptime reaches until_ms */
+void hybrid_listen(int64_t until_ms) {
+	int64_t remaining_ms = until_ms - k_uptime_get();
+	while (remaining_ms > 0 && device_settings.state == measurement) {
+		sit_receive_now(0, (uint32_t)remaining_ms * 1000);
+		msg_simple_t rx_poll_msg;
+		if (sit_check_msg((uint8_t*)&rx_poll_msg, sizeof(msg_simple_t)) 
+				&& rx_poll_msg.header.id == ss_twr_1_poll
+				&& rx_poll_msg.header.dest == device_settings.deviceID) {
+			sit_sstwr_response(&rx_poll_msg);
+		}
+		remaining_ms = until_ms - k_uptime_get();
+	}
+}
+
+/* 
+ * Anchor slot: every CONFIG_SIT_HYBRID_CHECK_CYCLES tag cycles one anchor 
+ * (in turn, chosen by the sequence of the tag poll) ranges to all other 
+ * anchors CONFIG_SIT_HYBRID_SLOT_MS after the tag poll.
+ */
+void hybrid_check(uint32_t poll_sequence, int64_t poll_time) {
+	if (device_settings.responder < ANCHOR_BASE_ID) {
+		return;
+	}
+	uint16_t anchors = device_settings.responder - ANCHOR_BASE_ID + 1;
+	if (anchors < 2 || poll_sequence % CONFIG_SIT_HYBRID_CHECK_CYCLES != 0) {
+		return;
+	}
+	sit_addr_t checker = ANCHOR_BASE_ID + (poll_sequence / CONFIG_SIT_HYBRID_CHECK_CYCLES) % anchors;
+	if (checker != device_settings.deviceID) {
+		return;
+	}
+	hybrid_listen(poll_time + CONFIG_SIT_HYBRID_SLOT_MS);
+	for (sit_addr_t anchor_id = ANCHOR_BASE_ID; anchor_id <= device_settings.responder; anchor_id++) {
+		if (anchor_id == device_settings.deviceID) {
+			continue;
+		}
+		if (sstwr_exchange(&initiator_session, anchor_id)) {
+			LOG_INF("Anchor check %u -> %u: %3.2lf m", device_settings.deviceID, anchor_id, 
+				initiator_session.distance);
+			send_twr_notify(&initiator_session, anchor_id);
 		} else {
+			LOG_WRN("Anchor check %u -> %u: no response", device_settings.deviceID, anchor_id);
+		}
+	}
+	initiator_session.sequence++;
+}
+#endif
+
+#define SEQUENCE_REPORT_POLLS 1000
+#ifdef CONFIG_SIT_SLOTS
+#define SEQUENCE_TAGS CONFIG_SIT_SLOTS_COUNT
+#else
+#define SEQUENCE_TAGS 1
+#endif
+
+/* every tag has its own session sequence */
+static struct {
+	sit_addr_t tag;
+	sit_sequence_t sequence;
+} poll_sequence[SEQUENCE_TAGS];
+static uint8_t poll_sequence_next;
+
+void reset_poll_sequence() {
+	for (uint8_t i = 0; i < SEQUENCE_TAGS; i++) {
+		poll_sequence[i].tag = SIT_ADDR_BROADCAST;
+		sit_sequence_reset(&poll_sequence[i].sequence);
+	}
+	poll_sequence_next = 0;
+}
+
+/* 
+ * Extend the sequence of a tag poll to the 32 bit session sequence. A poll 
+ * far behind starts a new session (the tag restarted). A duplicate is the 
+ * retry of an exchange which failed at the initiator, it is answered.
+ */
+void update_poll_sequence(sit_addr_t tag, uint16_t sequence) {
+	sit_sequence_t *tracker = NULL;
+	for (uint8_t i = 0; i < SEQUENCE_TAGS; i++) {
+		if (poll_sequence[i].tag == tag) {
+			tracker = &poll_sequence[i].sequence;
+		}
+	}
+	if (tracker == NULL) {
+		// new tag, replaces the oldest one
+		poll_sequence[poll_sequence_next].tag = tag;
+		tracker = &poll_sequence[poll_sequence_next].sequence;
+		sit_sequence_reset(tracker);
+		poll_sequence_next = (poll_sequence_next + 1) % SEQUENCE_TAGS;
+	}
+	uint32_t extended;
+	sit_sequence_status_t status = sit_sequence_update(tracker, sequence, &extended);
+	if (status == sit_sequence_restart) {
+		LOG_WRN("Poll %u of tag %u far behind, new session", sequence, tag);
+	}
+	responder_session.sequence = extended;
+	if (tracker->received % SEQUENCE_REPORT_POLLS == 0) {
+		LOG_INF("Polls of tag %u: %u received, %u lost, %u reordered, %u duplicates", tag,
+			tracker->received, tracker->lost, tracker->reordered, tracker->duplicates);
+	}
+}
+
+void sit_dstwr_responder() {
+	reset_poll_sequence();
+	#ifdef CONFIG_SIT_SLOTS
+		sit_slots_reset();
+	#endif
+	#ifdef CONFIG_SIT_RX_WINDOW
+		sit_rx_window_reset(&rx_window, (double)TWR_PERIOD_MS * 1000 * UUS_TO_DWT_TIME);
+		rx_window_polls = 0;
+	#endif
+	#ifdef CONFIG_SIT_SNIFF
+		sit_sniff_reset();
+	#endif
+	#ifdef CONFIG_SIT_DISCOVERY
+		sit_discovery_reset();
+	#endif
+	while(device_settings.state == measurement) { 
+		#ifdef CONFIG_SIT_RX_WINDOW
+			bool windowed = open_rx_window();
+			uint64_t poll_rx_ts = 0;
+		#else
+			responder_receive();
+		#endif
+		#if defined(CONFIG_SIT_RX_WINDOW) || defined(CONFIG_SIT_SNIFF) || defined(CONFIG_SIT_DISCOVERY)
+			bool poll_received = false;
+		#endif
+		#ifdef CONFIG_SIT_TEMP_COMP
+			int64_t idle_ms = 0;
+		#endif
+		#ifdef CONFIG_SIT_HYBRID
+			int64_t poll_time = k_uptime_get();
+		#endif
+		msg_simple_t rx_poll_msg;
+		bool frame_received = sit_check_msg((uint8_t*)&rx_poll_msg, sizeof(msg_simple_t));
+		#ifdef CONFIG_SIT_SLOTS
+			if (frame_received) {
+				sit_slots_frame(&rx_poll_msg.header);
+			}
+		#endif
+		// the responder answers DS-TWR and SS-TWR polls
+		bool poll_msg = frame_received
+				&& (rx_poll_msg.header.id == twr_1_poll || rx_poll_msg.header.id == ss_twr_1_poll)
+				&& rx_poll_msg.header.dest == device_settings.deviceID;
+		bool tag_poll = poll_msg;
+		#ifdef CONFIG_SIT_HYBRID
+			bool anchor_check = poll_msg && rx_poll_msg.header.source >= ANCHOR_BASE_ID;
+			if (anchor_check) {
+				// anchor check of another anchor, not a tag cycle
+				sit_sstwr_response(&rx_poll_msg);
+				tag_poll = false;
+			} else if (poll_msg) {
+				poll_time = k_uptime_get();
+			}
+		#endif
+		if (tag_poll) {
+			update_poll_sequence(rx_poll_msg.header.source, rx_poll_msg.header.sequence);
+			#if defined(CONFIG_SIT_RX_WINDOW) || defined(CONFIG_SIT_SNIFF) || defined(CONFIG_SIT_DISCOVERY)
+				poll_received = true;
+			#endif
+			#ifdef CONFIG_SIT_RX_WINDOW
+				poll_rx_ts = get_rx_timestamp_u64();
+			#endif
+			#ifdef CONFIG_SIT_TEMP_COMP
+				int64_t exchange_start = k_uptime_get();
+			#endif
+			if (rx_poll_msg.header.id == ss_twr_1_poll) {
+				// the distance is calculated at the initiator
+				sit_sstwr_response(&rx_poll_msg);
+			} else if (sit_dstwr_response(&responder_session, &rx_poll_msg)) {
+				send_twr_notify(&responder_session, device_settings.deviceID);
+				#ifdef CONFIG_SIT_CIR
+					// accumulator still holds the final message, read it in the idle gap
+					sit_cir_capture(responder_session.sequence);
+				#endif
+			}
+			#ifdef CONFIG_SIT_HYBRID
+				hybrid_check(responder_session.sequence, poll_time);
+			#endif
+			#ifdef CONFIG_SIT_TEMP_COMP
+				// the next poll is expected one period after this one
+				idle_ms = TWR_PERIOD_MS - (k_uptime_get() - exchange_start);
+			#endif
+		} else if (!poll_msg) {
 			LOG_WRN("Something is wrong with Poll Msg Receive");
             dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
 		}
-		sequence++;
-		k_msleep(90);
+		#ifdef CONFIG_SIT_TEMP_COMP
+			sit_temp_service(idle_ms);
+		#endif
+		#ifdef CONFIG_SIT_SNIFF
+			sit_sniff_update(poll_received);
+		#endif
+		#ifdef CONFIG_SIT_DISCOVERY
+			sit_discovery_responder(poll_received);
+		#endif
+		#ifdef CONFIG_SIT_SLOTS
+			sit_slots_service();
+		#endif
+		#ifdef CONFIG_SIT_RX_WINDOW
+			// the wait until the next poll is done in open_rx_window()
+			update_rx_window(windowed, poll_received, poll_rx_ts);
+		#elif defined(CONFIG_SIT_HYBRID)
+			// the anchor slot is in this gap, the receiver stays on
+			if (!anchor_check) {
+				hybrid_listen(poll_time + HYBRID_LISTEN_MS);
+			}
+		#elif defined(CONFIG_SIT_SLOTS)
+			// the next tag ranges in the next slot, the receiver stays on
+		#else
+			k_msleep(90);
+		#endif
+	}
+}
+
+#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+static sit_calibration_t calibration;
+
+/* A and B listen for the result of C after every round */
+void receive_calibration_result() {
+	sit_receive_now(0, DS_RESP_RX_TIMEOUT_UUS+2000);
+	msg_calibration_result_t result_msg;
+	if (!sit_check_calibration_result_msg_id(calibration_result, &result_msg)) {
+		return;
 	}
+	int16_t delay = device_settings.deviceID == 0 ? result_msg.delay_a : result_msg.delay_b;
+	uint16_t rx_ant_dly = device_settings.rx_ant_dly + delay / 2;
+	uint16_t tx_ant_dly = device_settings.tx_ant_dly + (delay - delay / 2);
+	LOG_INF("Calibration Result: RX %d -> %d, TX %d -> %d", 
+		device_settings.rx_ant_dly, rx_ant_dly, device_settings.tx_ant_dly, tx_ant_dly);
+	set_rx_ant_dly(rx_ant_dly);
+	set_tx_ant_dly(tx_ant_dly);
+	device_settings.state = sleep;
 }
 
+void reset_calibration() {
+	double to_dtu = 1.0 / (SPEED_OF_LIGHT * DWT_TIME_UNITS);
+	sit_calibration_reset(&calibration, 
+		device_settings.calibration_distance[0] * to_dtu,
+		device_settings.calibration_distance[1] * to_dtu,
+		device_settings.calibration_distance[2] * to_dtu);
+}
+
+/* Accumulate the round, send the result to A and B when it is solved */
+void update_calibration(uint64_t sensing_info_rx) {
+	sit_calibration_round_t round = {
+		.time_m21 = time_m21,
+		.time_m31 = time_m31,
+		.time_a21 = time_a21,
+		.time_a31 = time_a31,
+		.time_b21 = time_b21,
+		.time_b31 = time_b31,
+	};
+	if (!sit_calibration_add(&calibration, &round)) {
+		LOG_WRN("Calibration round %d discarded", calibration_session.sequence);
+		return;
+	}
+	sit_calibration_result_t result;
+	if (!sit_calibration_solve(&calibration, &result)) {
+		return;
+	}
+	uint32_t result_tx_time = (sensing_info_rx + (1800 * UUS_TO_DWT_TIME)) >> 8;
+	msg_calibration_result_t result_msg = {{
+		calibration_result,
+		(uint16_t)calibration_session.sequence,
+		device_settings.deviceID,
+		SIT_ADDR_BROADCAST},
+		result.delay_a,
+		result.delay_b,
+		0
+	};
+	sit_send_at((uint8_t*)&result_msg, sizeof(result_msg), result_tx_time);
+
+	json_calibration_msg_t calibration_notify = {
+		.header = {
+			.type = "cali_result",
+			.sequence = calibration_session.sequence,
+			.measurements = result.rounds,
+		},
+		.data = {
+			.delay_a = result.delay_a,
+			.delay_b = result.delay_b,
+			.std_a = result.std_a,
+			.std_b = result.std_b,
+			.rounds = result.rounds,
+		}
+	};
+	ble_sit_calibration_notify(&calibration_notify, sizeof(calibration_notify));
+	LOG_INF("Calibration: A %d (%3.2f), B %d (%3.2f) DTU", 
+		result.delay_a, result.std_a, result.delay_b, result.std_b);
+	device_settings.state = sleep;
+}
+#endif
+
 void sit_two_device_calibration_a() {
 	while(device_settings.state == measurement) {
 		uint64_t sensing_1_tx, sensing_2_rx, sensing_3_tx = 0;
-		LOG_INF("Two Device Calibration A: %d", sequence);
+		LOG_INF("Two Device Calibration A: %d", calibration_session.sequence);
 		sit_set_rx_after_tx_delay(POLL_TX_TO_RESP_RX_DLY_UUS);
 		sit_set_rx_timeout(DS_RESP_RX_TIMEOUT_UUS+2000);
 		sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);
-		msg_simple_t sensing_1_msg = {{sensing_1, (uint8_t)sequence, device_settings.deviceID, 1}, 0};
+		msg_simple_t sensing_1_msg = {{sensing_1, (uint16_t)calibration_session.sequence, device_settings.deviceID, 1}, 0};
 		sit_start_poll((uint8_t*) &sensing_1_msg, (uint16_t)sizeof(sensing_1_msg));
 
 		msg_simple_t resp_msg;
@@ -372,7 +1319,7 @@ void sit_two_device_calibration_a() {
 
 			msg_sensing_3_t sensing_3_msg = {{
 				sensing_3,
-				(uint8_t)sequence,
+				(uint16_t)calibration_session.sequence,
 				device_settings.deviceID,
 				2},
 				(uint32_t)sensing_1_tx,
@@ -388,17 +1335,20 @@ void sit_two_device_calibration_a() {
 			msg_sensing_info_t info_msg;
 			if(sit_check_sensing_info_msg_id(sensing_resp, &info_msg)){
 				LOG_INF("Sensing Info Final A");
+				#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+					receive_calibration_result();
+				#endif
 			}
 		}
-		sequence++;
-		k_msleep(1000);
+		calibration_session.sequence++;
+		k_msleep(CALIBRATION_ROUND_DELAY_MS);
 	}
 	LOG_INF("Simple Calibration Test");
 }
 
 void sit_two_device_calibration_b() {
 	while(device_settings.state == measurement) {
-		LOG_INF("Two Device Calibration B: %d", sequence);
+		LOG_INF("Two Device Calibration B: %d", calibration_session.sequence);
 		sit_receive_now(0,0);
 		msg_simple_t sensing_1_msg;
 		uint64_t sensing_1_rx, sensing_2_tx, sensing_3_rx = 0;
@@ -410,7 +1360,7 @@ void sit_two_device_calibration_b() {
 			sit_set_rx_after_tx_delay(1500);
 			sit_set_rx_timeout(DS_RESP_RX_TIMEOUT_UUS+2000);
 			sit_set_preamble_detection_timeout(DS_PRE_TIMEOUT+200);			
-			msg_simple_t sensing_2_msg = {{sensing_2, (uint8_t)sequence, device_settings.deviceID, 0}, 0};
+			msg_simple_t sensing_2_msg = {{sensing_2, (uint16_t)calibration_session.sequence, device_settings.deviceID, 0}, 0};
 			sit_send_at_with_response((uint8_t*) &sensing_2_msg, (uint16_t)sizeof(sensing_2_msg),sesing_2_tx_time);
 			msg_sensing_3_t resp_sensing_3;
 			if (sit_check_sensing_3_msg_id(sensing_3, &resp_sensing_3) ){
@@ -421,7 +1371,7 @@ void sit_two_device_calibration_b() {
 				uint32_t sesing_3_tx_time = (sensing_3_rx + (1800 * UUS_TO_DWT_TIME)) >> 8;
 				msg_sensing_info_t sensing_info = {{
 					sensing_resp,
-					(uint8_t)sequence,
+					(uint16_t)calibration_session.sequence,
 					device_settings.deviceID,
 					0},
 					(uint32_t)sensing_1_rx,
@@ -431,19 +1381,30 @@ void sit_two_device_calibration_b() {
 				};
 
 				sit_send_at((uint8_t*)&sensing_info, sizeof(sensing_info), sesing_3_tx_time);
+				#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+					receive_calibration_result();
+				#endif
 
 			}
 		}
-		sequence++;
-		k_msleep(500);
+		calibration_session.sequence++;
+		k_msleep(CALIBRATION_LISTEN_DELAY_MS);
 	}
 	LOG_INF("Simple Calibration Test");
 	k_msleep(500);
 }
 
 void sit_two_device_calibration_c() {
+	#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+		bool solver = device_settings.calibration_distance[0] > 0.0f;
+		if (solver) {
+			reset_calibration();
+		} else {
+			LOG_WRN("No calibration distance, send raw times");
+		}
+	#endif
 	while(device_settings.state == measurement) {
-		LOG_INF("Two Device Calibration C: %d", sequence);
+		LOG_INF("Two Device Calibration C: %d", calibration_session.sequence);
 		sit_receive_now(0,0);
 		msg_simple_t simple_poll_msg;
 		uint64_t sensing_1_rx, sensing_2_rx, sensing_3_rx = 0;
@@ -479,33 +1440,43 @@ void sit_two_device_calibration_c() {
 							time_tc_i = (double) (sensing_2_rx - sensing_1_rx);
 							time_tc_ii = (double) (sensing_3_rx - sensing_2_rx);
 
-							time_round_1 = (double) (sensing_3_msg.sensing_2_rx - sensing_3_msg.sensing_1_tx);
-							time_round_2 = (double) (sensing_info_msg.sensing_3_rx - sensing_info_msg.sensing_2_tx);
-							time_reply_1 = (double) (sensing_info_msg.sensing_2_tx - sensing_info_msg.sensing_1_rx);
-							time_reply_2 = (double) (sensing_3_msg.sensing_3_tx - sensing_3_msg.sensing_2_rx);
+							sit_session_t *session = &calibration_session;
+							session->time_round_1 = (double) (sensing_3_msg.sensing_2_rx - sensing_3_msg.sensing_1_tx);
+							session->time_round_2 = (double) (sensing_info_msg.sensing_3_rx - sensing_info_msg.sensing_2_tx);
+							session->time_reply_1 = (double) (sensing_info_msg.sensing_2_tx - sensing_info_msg.sensing_1_rx);
+							session->time_reply_2 = (double) (sensing_3_msg.sensing_3_tx - sensing_3_msg.sensing_2_rx);
 
 							uint64_t tof_dtu;
-							tof_dtu = (uint64_t)((time_round_1 * time_round_2 - time_reply_1 * time_reply_2) 
-										/ (time_round_1 + time_round_2 + time_reply_1 + time_reply_2)
+							tof_dtu = (uint64_t)((session->time_round_1 * session->time_round_2 
+										- session->time_reply_1 * session->time_reply_2) 
+										/ (session->time_round_1 + session->time_round_2 
+										+ session->time_reply_1 + session->time_reply_2)
 									);
 
 							double tof = (double)tof_dtu * DWT_TIME_UNITS;
-							distance = tof * SPEED_OF_LIGHT;
-
-							send_two_device_notify();
+							session->distance = tof * SPEED_OF_LIGHT;
+
+							#ifdef CONFIG_SIT_CALIBRATION_SOLVER
+								if (solver) {
+									update_calibration(get_rx_timestamp_u64());
+								} else {
+									send_two_device_notify();
+								}
+							#else
+								send_two_device_notify();
+							#endif
 						} 
 				}
 			}
 		}
-		sequence++;
-		k_msleep(500);
+		calibration_session.sequence++;
+		k_msleep(CALIBRATION_LISTEN_DELAY_MS);
 	}
 	LOG_INF("Simple Calibration Test");
 }
 
 
-uint8_t sit_init() {
-	device_init();
+uint8_t sit_reconfigure() {
 	/* Configure SPI rate, for initialize it should not faster than 7 MHz */
 	port_set_dw_ic_spi_slowrate();
 	
@@ -544,6 +1515,16 @@ uint8_t sit_init() {
 	dwt_configuretxrf(&txconfig_options_ch9_sit);
 
 	set_antenna_delay(device_settings.rx_ant_dly, device_settings.tx_ant_dly);
+	#ifdef CONFIG_SIT_XTAL_TRIM
+		// trim of the running controller, 0 before the first sit_init()
+		if (xtal.trim) {
+			dwt_setxtaltrim(xtal.trim);
+		}
+	#endif
+	#ifdef CONFIG_SIT_TEMP_COMP
+		// antenna delays with the offset of the last temperature, no-op before sit_temp_init()
+		sit_temp_apply();
+	#endif
 
 	/* Next can enable TX/RX states output on GPIOs 5 and 6 to help debug, and also TX/RX LEDs
 	 * Note, in real low power applications the LEDs should not be used. */
@@ -551,7 +1532,30 @@ uint8_t sit_init() {
 
 	/* Enable Diacnostic all */
 	dwt_configciadiag(DW_CIA_DIAG_LOG_ALL);
- 	k_msleep(100);
+	#ifdef CONFIG_SIT_POWER_SLEEP
+		sit_power_init();
+	#endif
+	return 1;
+}
+
+uint8_t sit_init() {
+	device_init();
+	uint8_t ret = sit_reconfigure();
+	if (ret != 1) {
+		return ret;
+	}
+	#ifdef CONFIG_SIT_XTAL_TRIM
+		if (device_settings.xtal_trim) {
+			dwt_setxtaltrim(device_settings.xtal_trim);
+		}
+		sit_xtal_reset(&xtal, device_settings.xtal_trim ? device_settings.xtal_trim : dwt_getxtaltrim());
+	#endif
+	#ifdef CONFIG_SIT_TEMP_COMP
+		sit_temp_init(&txconfig_options_ch9_sit);
+	#endif
+	#ifndef CONFIG_SIT_FAST_BOOT
+ 		k_msleep(100);
+	#endif
 
 	return 1;
 }
@@ -559,10 +1563,15 @@ uint8_t sit_init() {
 void sit_run_forever(){
 	ble_start_connection();
 	while(42) { //Life, the universe, and everything
-		if(is_connected()){
+		if(is_connected() || is_autostart()){
 			if (device_settings.measurement_type == ss_twr && device_type == initiator) {
-					sit_dstwr_initiator();
+					sit_sstwr_initiator();
 			} else if (device_settings.measurement_type == ss_twr && device_type == responder) {
+					// the responder answers both poll types
+					sit_dstwr_responder();
+			} else if (device_settings.measurement_type == twr_compare && device_type == initiator) {
+					sit_twr_compare_initiator();
+			} else if (device_settings.measurement_type == twr_compare && device_type == responder) {
 					sit_dstwr_responder();
 			} else if (device_settings.measurement_type == ds_3_twr && device_type == initiator) {
 					sit_dstwr_initiator();
@@ -574,6 +1583,18 @@ void sit_run_forever(){
 					sit_two_device_calibration_b();
 			} else if  (device_settings.measurement_type == two_device_calibration && device_type == dev_c) {
 					sit_two_device_calibration_c();
+			#ifdef CONFIG_SIT_SURVEY
+			} else if  (device_settings.measurement_type == anchor_survey && device_type == responder) {
+					sit_survey_run();
+			#endif
+			#ifdef CONFIG_SIT_ALL_TWR
+			} else if  (device_settings.measurement_type == ds_all_twr) {
+					sit_all_twr_run();
+			#endif
+			#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+			} else if  (device_settings.measurement_type == extended_calibration) {
+					sit_all_twr_run();
+			#endif
 			}
 		} else {
 			ble_wait_for_connection();
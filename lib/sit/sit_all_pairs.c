@@ -0,0 +1,196 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_all_pairs.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the all-pairs ranging solver (ds_all_twr).
+ *
+ * Round numbers are 8 bit and wrap, a reception is only reported if it is
+ * from the round the slot order expects, so stale timestamps are never
+ * combined. The distance uses the asymmetric DS-TWR formula, which cancels
+ * the clock offsets of both nodes.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_all_pairs.h"
+
+#include <string.h>
+
+#define TS_MASK 0xFFFFFFFFFFULL
+
+bool sit_all_pairs_init(sit_all_pairs_t *ctx, uint8_t node, uint8_t nodes) {
+    if (nodes < 2 || nodes > SIT_ALL_PAIRS_MAX_NODES || nodes > 32 || node >= nodes) {
+        return false;
+    }
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->node = node;
+    ctx->nodes = nodes;
+    return true;
+}
+
+static void store_frame(sit_all_pairs_t *ctx, const sit_all_pairs_frame_t *frame) {
+    uint8_t index = frame->round & 1;
+    ctx->frames[frame->node][index] = *frame;
+    ctx->frames_valid[frame->node] |= (uint8_t)(1 << index);
+}
+
+static const sit_all_pairs_frame_t *get_frame(const sit_all_pairs_t *ctx, uint8_t node, uint8_t round) {
+    uint8_t index = round & 1;
+    if (!(ctx->frames_valid[node] & (1 << index)) || ctx->frames[node][index].round != round) {
+        return NULL;
+    }
+    return &ctx->frames[node][index];
+}
+
+void sit_all_pairs_build(sit_all_pairs_t *ctx, uint8_t round, uint64_t tx_ts, sit_all_pairs_frame_t *frame) {
+    memset(frame, 0, sizeof(*frame));
+    frame->node = ctx->node;
+    frame->round = round;
+    frame->tx_ts = tx_ts & TS_MASK;
+    for (uint8_t j = 0; j < ctx->nodes; j++) {
+        if (j == ctx->node || !(ctx->rx_valid & (1UL << j))) {
+            continue;
+        }
+        // lower slots were heard in this round, higher slots in the last one
+        uint8_t expected = j < ctx->node ? round : (uint8_t)(round - 1);
+        if (ctx->rx_round[j] == expected) {
+            frame->rx_ts[j] = ctx->rx_ts[j];
+            frame->heard |= 1UL << j;
+        }
+    }
+    store_frame(ctx, frame);
+}
+
+void sit_all_pairs_receive(sit_all_pairs_t *ctx, const sit_all_pairs_frame_t *frame, uint64_t rx_ts) {
+    if (frame->node >= ctx->nodes || frame->node == ctx->node) {
+        return;
+    }
+    ctx->rx_ts[frame->node] = rx_ts & TS_MASK;
+    ctx->rx_round[frame->node] = frame->round;
+    ctx->rx_valid |= 1UL << frame->node;
+    store_frame(ctx, frame);
+}
+
+static uint8_t latest_round(const sit_all_pairs_t *ctx, uint8_t node) {
+    const sit_all_pairs_frame_t *f0 = &ctx->frames[node][0];
+    const sit_all_pairs_frame_t *f1 = &ctx->frames[node][1];
+    if (!(ctx->frames_valid[node] & 2)) {
+        return f0->round;
+    }
+    if (!(ctx->frames_valid[node] & 1)) {
+        return f1->round;
+    }
+    // the two rounds differ by one (mod 256)
+    return (uint8_t)(f0->round - f1->round) == 1 ? f0->round : f1->round;
+}
+
+bool sit_all_pairs_tof(const sit_all_pairs_t *ctx, uint8_t a, uint8_t b, double *tof_dtu) {
+    if (a == b || a >= ctx->nodes || b >= ctx->nodes) {
+        return false;
+    }
+    if (a > b) {
+        uint8_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+    if (!ctx->frames_valid[b]) {
+        return false;
+    }
+    // b has the later slot, its last frame closes the exchange
+    uint8_t next = latest_round(ctx, b);
+    uint8_t round = (uint8_t)(next - 1);
+    const sit_all_pairs_frame_t *poll = get_frame(ctx, a, round);
+    const sit_all_pairs_frame_t *resp = get_frame(ctx, b, round);
+    const sit_all_pairs_frame_t *final = get_frame(ctx, a, next);
+    const sit_all_pairs_frame_t *report = get_frame(ctx, b, next);
+    if (!poll || !resp || !final || !report
+            || !(resp->heard & (1UL << a))
+            || !(final->heard & (1UL << b))
+            || !(report->heard & (1UL << a))) {
+        return false;
+    }
+
+    double round_a = (double)((final->rx_ts[b] - poll->tx_ts) & TS_MASK);
+    double reply_b = (double)((resp->tx_ts - resp->rx_ts[a]) & TS_MASK);
+    double round_b = (double)((report->rx_ts[a] - resp->tx_ts) & TS_MASK);
+    double reply_a = (double)((final->tx_ts - final->rx_ts[b]) & TS_MASK);
+    *tof_dtu = (round_a * round_b - reply_a * reply_b) / (round_a + round_b + reply_a + reply_b);
+    return true;
+}
+
+static void write_ts(uint8_t *buffer, uint64_t ts) {
+    for (uint8_t i = 0; i < SIT_ALL_PAIRS_TS_LEN; i++) {
+        buffer[i] = (uint8_t)(ts >> (8 * i));
+    }
+}
+
+static uint64_t read_ts(const uint8_t *buffer) {
+    uint64_t ts = 0;
+    for (int8_t i = SIT_ALL_PAIRS_TS_LEN - 1; i >= 0; i--) {
+        ts = (ts << 8) | buffer[i];
+    }
+    return ts;
+}
+
+uint16_t sit_all_pairs_pack(const sit_all_pairs_frame_t *frame, uint8_t *buffer) {
+    uint16_t length = 0;
+    buffer[length++] = frame->round;
+    write_ts(&buffer[length], frame->tx_ts);
+    length += SIT_ALL_PAIRS_TS_LEN;
+    for (uint8_t i = 0; i < 4; i++) {
+        buffer[length++] = (uint8_t)(frame->heard >> (8 * i));
+    }
+    for (uint8_t j = 0; j < SIT_ALL_PAIRS_MAX_NODES && j < 32; j++) {
+        if (frame->heard & (1UL << j)) {
+            write_ts(&buffer[length], frame->rx_ts[j]);
+            length += SIT_ALL_PAIRS_TS_LEN;
+        }
+    }
+    return length;
+}
+
+bool sit_all_pairs_unpack(const uint8_t *buffer, uint16_t length, uint8_t node, sit_all_pairs_frame_t *frame) {
+    uint16_t offset = 0;
+    if (length < 1 + SIT_ALL_PAIRS_TS_LEN + 4) {
+        return false;
+    }
+    memset(frame, 0, sizeof(*frame));
+    frame->node = node;
+    frame->round = buffer[offset++];
+    frame->tx_ts = read_ts(&buffer[offset]);
+    offset += SIT_ALL_PAIRS_TS_LEN;
+    for (uint8_t i = 0; i < 4; i++) {
+        frame->heard |= (uint32_t)buffer[offset++] << (8 * i);
+    }
+    for (uint8_t j = 0; j < 32; j++) {
+        if (!(frame->heard & (1UL << j))) {
+            continue;
+        }
+        if (j >= SIT_ALL_PAIRS_MAX_NODES || offset + SIT_ALL_PAIRS_TS_LEN > length) {
+            return false;
+        }
+        frame->rx_ts[j] = read_ts(&buffer[offset]);
+        offset += SIT_ALL_PAIRS_TS_LEN;
+    }
+    return true;
+}
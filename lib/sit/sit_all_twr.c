@@ -0,0 +1,297 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_all_twr.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the all-pairs ranging mode (ds_all_twr).
+ *
+ * Slot timing in the 32 bit system time (256 DWT time units):
+ * - node 0 sends every nodes * CONFIG_SIT_ALL_TWR_SLOT_UUS
+ * - node i sends i slots after node 0, the start of the own slot is
+ *   calculated from the RX timestamp of any frame in the round
+ * - between the own frames the receiver is on, it is switched off
+ *   SIT_ALL_TWR_GUARD_UUS before the own slot
+ *
+ * The TX timestamp is known before the frame is sent (delayed TX), so it
+ * is part of the frame itself. The distances to the other nodes are sent
+ * as distance_msg over BLE, all pairs are logged every
+ * SIT_ALL_TWR_REPORT_ROUNDS rounds.
+ *
+ * In the extended_calibration mode the distances are compared with the
+ * known positions of the nodes instead. After CONFIG_SIT_CALIBRATION_ROUNDS
+ * rounds every node solves the antenna delays of all nodes, applies its
+ * own delay and notifies all delays over BLE.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_all_twr.h"
+#include "sit/sit_all_pairs.h"
+#include "sit/sit.h"
+#include "sit/sit_config.h"
+#include "sit/sit_device.h"
+#include "sit/sit_distance.h"
+#include "sit/sit_utils.h"
+#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+	#include "sit/sit_calibration.h"
+	#include <sit_ble/ble_init.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include <deca_device_api.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_ALL_TWR, LOG_LEVEL_INF);
+
+#define SIT_ALL_TWR_GUARD_UUS 300
+#define SIT_ALL_TWR_START_UUS 5000
+#define SIT_ALL_TWR_REPORT_ROUNDS 10
+#define SIT_ALL_TWR_BROADCAST SIT_ADDR_BROADCAST
+
+#define SLOT_HI32 ((uint32_t)(((uint64_t)CONFIG_SIT_ALL_TWR_SLOT_UUS * UUS_TO_DWT_TIME) >> 8))
+
+static sit_all_pairs_t all_pairs;
+static sit_session_t all_twr_session;
+static uint8_t frame_buffer[sizeof(header_t) + SIT_ALL_PAIRS_MAX_PAYLOAD + 2];
+
+#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+static sit_calibration_n_t calibration;
+static float calibration_position[SIT_ALL_PAIRS_MAX_NODES][3];
+static uint32_t calibration_position_set;
+static uint32_t calibration_rounds;
+
+void sit_all_twr_set_calibration_position(uint8_t index, float x, float y, float z) {
+	if (index >= SIT_ALL_PAIRS_MAX_NODES) {
+		return;
+	}
+	calibration_position[index][0] = x;
+	calibration_position[index][1] = y;
+	calibration_position[index][2] = z;
+	calibration_position_set |= 1UL << index;
+}
+
+static bool calibration_reset(uint8_t nodes) {
+	if (!sit_calibration_n_reset(&calibration, nodes)) {
+		LOG_ERR("Extended calibration needs 3 .. %u nodes", SIT_CALIBRATION_MAX_DEVICES);
+		return false;
+	}
+	for (uint8_t a = 0; a < nodes; a++) {
+		if (!(calibration_position_set & (1UL << a))) {
+			LOG_ERR("No calibration position for node %u", SIT_ALL_TWR_FIRST_ID + a);
+			return false;
+		}
+		for (uint8_t b = a + 1; b < nodes; b++) {
+			float dx = calibration_position[a][0] - calibration_position[b][0];
+			float dy = calibration_position[a][1] - calibration_position[b][1];
+			float dz = calibration_position[a][2] - calibration_position[b][2];
+			double tof = sqrt(dx * dx + dy * dy + dz * dz) / (SPEED_OF_LIGHT * DWT_TIME_UNITS);
+			sit_calibration_n_set_tof(&calibration, a, b, tof);
+		}
+	}
+	calibration_rounds = 0;
+	return true;
+}
+
+/* Solve after CONFIG_SIT_CALIBRATION_ROUNDS rounds, retry until twice as many rounds */
+static void calibration_finish(void) {
+	calibration_rounds++;
+	if (calibration_rounds < CONFIG_SIT_CALIBRATION_ROUNDS) {
+		return;
+	}
+	sit_calibration_n_result_t result;
+	if (!sit_calibration_n_solve(&calibration, CONFIG_SIT_CALIBRATION_ROUNDS / 2, &result)) {
+		if (calibration_rounds >= 2 * CONFIG_SIT_CALIBRATION_ROUNDS) {
+			LOG_ERR("Extended calibration failed, not enough pairs");
+			device_settings.state = sleep;
+		}
+		return;
+	}
+	LOG_INF("Extended calibration: %u pairs, RMS %3.2f DTU", result.pairs, result.rms);
+	for (uint8_t i = 0; i < calibration.devices; i++) {
+		json_calibration_msg_t calibration_notify = {
+			.header = {
+				.type = "cali_result",
+				.sequence = SIT_ALL_TWR_FIRST_ID + i,
+				.measurements = calibration.devices,
+			},
+			.data = {
+				.delay_a = result.delay[i],
+				.std_a = result.std[i],
+				.rounds = result.rounds,
+			}
+		};
+		ble_sit_calibration_notify(&calibration_notify, sizeof(calibration_notify));
+		LOG_INF("Node %u: %d (%3.2f) DTU", SIT_ALL_TWR_FIRST_ID + i, result.delay[i], result.std[i]);
+	}
+	int16_t delay = result.delay[all_pairs.node];
+	uint16_t rx_ant_dly = device_settings.rx_ant_dly + delay / 2;
+	uint16_t tx_ant_dly = device_settings.tx_ant_dly + (delay - delay / 2);
+	LOG_INF("Calibration Result: RX %d -> %d, TX %d -> %d", 
+		device_settings.rx_ant_dly, rx_ant_dly, device_settings.tx_ant_dly, tx_ant_dly);
+	set_rx_ant_dly(rx_ant_dly);
+	set_tx_ant_dly(tx_ant_dly);
+	device_settings.state = sleep;
+}
+#endif
+
+static uint8_t all_twr_nodes(void) {
+	uint8_t nodes = device_settings.responder - SIT_ALL_TWR_FIRST_ID + 1;
+	return MIN(nodes, SIT_ALL_PAIRS_MAX_NODES);
+}
+
+static uint32_t hi32_to_uus(uint32_t hi32) {
+	return (uint32_t)(((uint64_t)hi32 << 8) / UUS_TO_DWT_TIME);
+}
+
+/* Start of the own slot after a frame of node sender in round, returns the own round */
+static uint8_t align_slot(uint8_t sender, uint8_t round, uint64_t rx_ts, uint32_t *tx_time) {
+	uint8_t node = all_pairs.node;
+	uint8_t slots = node > sender ? node - sender : all_pairs.nodes - sender + node;
+	*tx_time = (uint32_t)(rx_ts >> 8) + slots * SLOT_HI32;
+	return node > sender ? round : (uint8_t)(round + 1);
+}
+
+/* Receive until the guard time before tx_time, true if a frame was received */
+static bool all_twr_listen(bool synced, uint32_t *tx_time, uint8_t *round) {
+	uint32_t timeout_uus = 0;
+	if (synced) {
+		int32_t remaining = (int32_t)(*tx_time - dwt_readsystimestamphi32());
+		uint32_t remaining_uus = remaining > 0 ? hi32_to_uus((uint32_t)remaining) : 0;
+		if (remaining_uus <= 2 * SIT_ALL_TWR_GUARD_UUS) {
+			return false;
+		}
+		timeout_uus = remaining_uus - SIT_ALL_TWR_GUARD_UUS;
+	} else {
+		timeout_uus = 2 * all_pairs.nodes * CONFIG_SIT_ALL_TWR_SLOT_UUS;
+	}
+	sit_receive_now(0, timeout_uus);
+	if (!sit_check_any_msg(frame_buffer, sizeof(frame_buffer))) {
+		return false;
+	}
+	header_t *header = (header_t*)frame_buffer;
+	uint16_t sender = header->source - SIT_ALL_TWR_FIRST_ID;
+	uint16_t length = dwt_getframelength();
+	if (header->id != all_twr_frame || sender >= all_pairs.nodes || length < sizeof(header_t) + 2) {
+		return false;
+	}
+	sit_all_pairs_frame_t frame;
+	uint64_t rx_ts = get_rx_timestamp_u64();
+	if (!sit_all_pairs_unpack(&frame_buffer[sizeof(header_t)], length - sizeof(header_t) - 2, sender, &frame)) {
+		LOG_WRN("Invalid all-pairs frame from %u", header->source);
+		return false;
+	}
+	sit_all_pairs_receive(&all_pairs, &frame, rx_ts);
+	if (all_pairs.node != 0) {
+		// node 0 keeps the time, every other node follows the last frame
+		*round = align_slot(sender, frame.round, rx_ts, tx_time);
+	}
+	return true;
+}
+
+static bool all_twr_send(uint32_t tx_time, uint8_t round) {
+	// the TX timestamp is known before the frame is sent: delayed TX time + antenna delay
+	uint64_t tx_ts = ((((uint64_t)(tx_time & 0xFFFFFFFEUL)) << 8) + get_tx_ant_dly()) 
+		& TIMESTAMP_U40_MASK;
+	sit_all_pairs_frame_t frame;
+	sit_all_pairs_build(&all_pairs, round, tx_ts, &frame);
+
+	header_t header = {all_twr_frame, round, device_settings.deviceID, SIT_ALL_TWR_BROADCAST};
+	memcpy(frame_buffer, &header, sizeof(header));
+	uint16_t length = sizeof(header_t) + sit_all_pairs_pack(&frame, &frame_buffer[sizeof(header_t)]) + 2;
+	return sit_send_at(frame_buffer, length, tx_time);
+}
+
+static void all_twr_report(uint8_t round) {
+	uint8_t node = all_pairs.node;
+	bool calibrating = device_settings.measurement_type == extended_calibration;
+	for (uint8_t a = 0; a < all_pairs.nodes; a++) {
+		for (uint8_t b = a + 1; b < all_pairs.nodes; b++) {
+			double tof;
+			if (!sit_all_pairs_tof(&all_pairs, a, b, &tof)) {
+				continue;
+			}
+			double pair_distance = tof * DWT_TIME_UNITS * SPEED_OF_LIGHT;
+			#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+				if (calibrating) {
+					sit_calibration_n_add(&calibration, a, b, tof);
+				}
+			#endif
+			if (!calibrating && (a == node || b == node)) {
+				all_twr_session.distance = pair_distance;
+				send_twr_notify(&all_twr_session, SIT_ALL_TWR_FIRST_ID + (a == node ? b : a));
+			}
+			if (round % SIT_ALL_TWR_REPORT_ROUNDS == 0) {
+				LOG_INF("Distance %u <-> %u: %3.2lf", SIT_ALL_TWR_FIRST_ID + a,
+					SIT_ALL_TWR_FIRST_ID + b, pair_distance);
+			}
+		}
+	}
+	#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+		if (calibrating) {
+			calibration_finish();
+		}
+	#endif
+}
+
+void sit_all_twr_run(void) {
+	uint8_t nodes = all_twr_nodes();
+	if (!sit_all_pairs_init(&all_pairs, device_settings.deviceID - SIT_ALL_TWR_FIRST_ID, nodes)) {
+		LOG_ERR("Device %u is not a node of the %u all-pairs nodes", device_settings.deviceID, nodes);
+		device_settings.state = sleep;
+		return;
+	}
+	#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+		if (device_settings.measurement_type == extended_calibration && !calibration_reset(nodes)) {
+			device_settings.state = sleep;
+			return;
+		}
+	#endif
+	all_twr_session = (sit_session_t){0};
+	bool synced = all_pairs.node == 0;
+	uint8_t round = 0;
+	uint32_t tx_time = dwt_readsystimestamphi32() 
+		+ (uint32_t)(((uint64_t)SIT_ALL_TWR_START_UUS * UUS_TO_DWT_TIME) >> 8);
+	sit_set_rx_after_tx_delay(0);
+
+	while (device_settings.state == measurement) {
+		bool received = all_twr_listen(synced, &tx_time, &round);
+		if (!synced) {
+			synced = received;
+			continue;
+		}
+		int32_t remaining = (int32_t)(tx_time - dwt_readsystimestamphi32());
+		if (remaining > 0 && hi32_to_uus((uint32_t)remaining) > 2 * SIT_ALL_TWR_GUARD_UUS) {
+			continue;
+		}
+		if (remaining <= 0 || !all_twr_send(tx_time, round)) {
+			LOG_WRN("All-pairs slot missed in round %u", round);
+		} else {
+			all_twr_report(round);
+			all_twr_session.sequence++;
+		}
+		tx_time += nodes * SLOT_HI32;
+		round++;
+	}
+}
@@ -0,0 +1,185 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_anchor_select.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the anchor subset selection.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_anchor_select.h"
+
+#include <math.h>
+#include <float.h>
+
+#define SIT_ANCHOR_GDOP_EPS      1e-3f  // regularisation while the subset is too small
+#define SIT_ANCHOR_MIN_DET       1e-9f
+#define SIT_ANCHOR_LINK_ALPHA    0.2f   // EWMA weight of a new ranging result
+#define SIT_ANCHOR_NLOS_PENALTY  0.8f   // quality loss of a 100 % NLOS link
+
+/**
+ * Trace of the inverse of the weighted information matrix H^T W H + eps I.
+ */
+static float weighted_trace_inverse(
+    const sit_vec3_t *anchors,
+    const float *link_quality,
+    const uint8_t *subset,
+    uint8_t count,
+    const sit_vec3_t *position,
+    uint8_t dim,
+    float eps
+) {
+    float a[3][3] = {{0}};
+    for (uint8_t i = 0; i < count; i++) {
+        const sit_vec3_t *anchor = &anchors[subset[i]];
+        float u[3] = {
+            position->x - anchor->x,
+            position->y - anchor->y,
+            position->z - anchor->z,
+        };
+        float range = sqrtf(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        if (range < 0.001f) {
+            continue;
+        }
+        float w = link_quality[subset[i]];
+        for (uint8_t r = 0; r < dim; r++) {
+            for (uint8_t c = 0; c < dim; c++) {
+                a[r][c] += w * (u[r] / range) * (u[c] / range);
+            }
+        }
+    }
+    for (uint8_t r = 0; r < dim; r++) {
+        a[r][r] += eps;
+    }
+
+    if (dim == 2) {
+        float det = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        if (fabsf(det) < SIT_ANCHOR_MIN_DET) {
+            return FLT_MAX;
+        }
+        return (a[0][0] + a[1][1]) / det;
+    }
+
+    float c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+    float c11 = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+    float c22 = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    float det = a[0][0] * c00
+              + a[0][1] * (a[1][2] * a[2][0] - a[1][0] * a[2][2])
+              + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    if (fabsf(det) < SIT_ANCHOR_MIN_DET) {
+        return FLT_MAX;
+    }
+    return (c00 + c11 + c22) / det;
+}
+
+float sit_anchor_gdop(
+    const sit_vec3_t *anchors,
+    const float *link_quality,
+    const uint8_t *subset,
+    uint8_t count,
+    const sit_vec3_t *position,
+    bool solve_3d
+) {
+    uint8_t dim = solve_3d ? 3 : 2;
+    if (count < dim) {
+        return FLT_MAX;
+    }
+    float trace = weighted_trace_inverse(anchors, link_quality, subset, count, position, dim, 0.0f);
+    if (trace == FLT_MAX || trace < 0.0f) {
+        return FLT_MAX;
+    }
+    return sqrtf(trace);
+}
+
+uint8_t sit_anchor_select(
+    const sit_vec3_t *anchors,
+    const float *link_quality,
+    uint8_t count,
+    const sit_vec3_t *position,
+    bool solve_3d,
+    uint8_t k,
+    uint8_t *selected
+) {
+    uint8_t dim = solve_3d ? 3 : 2;
+    bool used[SIT_POSITION_MAX_ANCHORS] = {false};
+    uint8_t selected_count = 0;
+
+    if (count > SIT_POSITION_MAX_ANCHORS) {
+        count = SIT_POSITION_MAX_ANCHORS;
+    }
+
+    // greedy forward selection, regularised so the first anchors can be rated
+    while (selected_count < k) {
+        float best_cost = FLT_MAX;
+        int16_t best = -1;
+        for (uint8_t i = 0; i < count; i++) {
+            if (used[i] || link_quality[i] < SIT_ANCHOR_MIN_QUALITY) {
+                continue;
+            }
+            selected[selected_count] = i;
+            float cost = weighted_trace_inverse(anchors, link_quality, selected,
+                            selected_count + 1, position, dim, SIT_ANCHOR_GDOP_EPS);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        selected[selected_count++] = (uint8_t)best;
+        used[best] = true;
+    }
+
+    if (selected_count < dim + 1) {
+        return selected_count;
+    }
+
+    // one pass of swaps to escape the greedy choice
+    float cost = sit_anchor_gdop(anchors, link_quality, selected, selected_count, position, solve_3d);
+    for (uint8_t s = 0; s < selected_count; s++) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (used[i] || link_quality[i] < SIT_ANCHOR_MIN_QUALITY) {
+                continue;
+            }
+            uint8_t old = selected[s];
+            selected[s] = i;
+            float swap_cost = sit_anchor_gdop(anchors, link_quality, selected, selected_count, position, solve_3d);
+            if (swap_cost < cost) {
+                cost = swap_cost;
+                used[old] = false;
+                used[i] = true;
+            } else {
+                selected[s] = old;
+            }
+        }
+    }
+    return selected_count;
+}
+
+void sit_anchor_link_update(float *quality, bool success, uint8_t nlos) {
+    float sample = 0.0f;
+    if (success) {
+        sample = 1.0f - SIT_ANCHOR_NLOS_PENALTY * ((float)nlos / 100.0f);
+    }
+    *quality += SIT_ANCHOR_LINK_ALPHA * (sample - *quality);
+}
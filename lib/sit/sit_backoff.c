@@ -0,0 +1,63 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_backoff.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the random backoff for the channel access with CCA.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_backoff.h"
+
+static uint32_t draw(const sit_backoff_t *backoff, sit_backoff_stats_t *stats, uint32_t random) {
+    uint32_t periods = random % (1UL << backoff->exponent);
+    stats->backoff_periods += periods;
+    return periods;
+}
+
+uint32_t sit_backoff_start(sit_backoff_t *backoff, sit_backoff_stats_t *stats, uint32_t random) {
+    backoff->backoffs = 0;
+    backoff->exponent = CONFIG_SIT_CCA_MIN_BE;
+    stats->polls++;
+    return draw(backoff, stats, random);
+}
+
+int32_t sit_backoff_busy(sit_backoff_t *backoff, sit_backoff_stats_t *stats, uint32_t random) {
+    stats->busy++;
+    backoff->backoffs++;
+    if (backoff->backoffs > CONFIG_SIT_CCA_MAX_BACKOFFS) {
+        stats->dropped++;
+        return -1;
+    }
+    if (backoff->exponent < CONFIG_SIT_CCA_MAX_BE) {
+        backoff->exponent++;
+    }
+    stats->retries++;
+    return (int32_t)draw(backoff, stats, random);
+}
+
+void sit_backoff_result(sit_backoff_stats_t *stats, bool response) {
+    if (!response) {
+        stats->no_response++;
+    }
+}
@@ -0,0 +1,69 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_boot.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the boot phase timestamps.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_boot.h"
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_BOOT, LOG_LEVEL_INF);
+
+static const char *phase_names[boot_phases] = {
+	"main",
+	"led",
+	"settings",
+	"ble",
+	"uwb",
+	"first range",
+};
+
+static uint32_t boot_timestamps[boot_phases];
+
+static void report(void) {
+	for (uint8_t i = 0; i < boot_phases; i++) {
+		if (boot_timestamps[i] != 0) {
+			LOG_INF("Boot %-12s %8u us", phase_names[i], boot_timestamps[i]);
+		}
+	}
+	LOG_INF("Boot to first range: %u ms", boot_timestamps[boot_first_range] / 1000U);
+}
+
+void sit_boot_mark(sit_boot_phase_t phase) {
+	if (phase >= boot_phases || boot_timestamps[phase] != 0) {
+		return;
+	}
+	// 0 marks a phase as not reached
+	boot_timestamps[phase] = MAX((uint32_t)k_ticks_to_us_floor64(k_uptime_ticks()), 1U);
+	if (phase == boot_first_range) {
+		report();
+	}
+}
+
+uint32_t sit_boot_get(sit_boot_phase_t phase) {
+	return phase < boot_phases ? boot_timestamps[phase] : 0;
+}
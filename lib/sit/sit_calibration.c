@@ -0,0 +1,269 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_calibration.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the antenna delay solvers.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_calibration.h"
+
+#include <math.h>
+#include <string.h>
+
+void sit_welford_add(sit_welford_t *welford, double value) {
+    welford->n++;
+    double delta = value - welford->mean;
+    welford->mean += delta / welford->n;
+    welford->m2 += delta * (value - welford->mean);
+}
+
+double sit_welford_variance(const sit_welford_t *welford) {
+    return welford->n > 1 ? welford->m2 / (welford->n - 1) : 0.0;
+}
+
+void sit_calibration_reset(sit_calibration_t *calibration, double tof_ab, double tof_ac, double tof_bc) {
+    memset(calibration, 0, sizeof(*calibration));
+    calibration->tof_ab = tof_ab;
+    calibration->tof_ac = tof_ac;
+    calibration->tof_bc = tof_bc;
+}
+
+bool sit_calibration_add(sit_calibration_t *calibration, const sit_calibration_round_t *round) {
+    if (round->time_b31 <= 0.0) {
+        return false;
+    }
+    // A and B see the same sensing 1 -> 3 interval as C (same emitter)
+    double drift_a = round->time_m31 / round->time_b31;
+    double drift_b = round->time_a31 / round->time_b31;
+    if (fabs(drift_a - 1.0) > SIT_CALIBRATION_MAX_DRIFT || fabs(drift_b - 1.0) > SIT_CALIBRATION_MAX_DRIFT) {
+        return false;
+    }
+
+    double reply_a = round->time_m31 - round->time_m21;
+    double reply_b = round->time_a21;
+    double round_a = round->time_m21;
+    double round_b = round->time_a31 - round->time_a21;
+
+    double e_a = (round->time_b31 - round->time_b21) - reply_a / drift_a
+        - (calibration->tof_ab + calibration->tof_ac - calibration->tof_bc);
+    double e_b = round->time_b21 - reply_b / drift_b
+        - (calibration->tof_ab + calibration->tof_bc - calibration->tof_ac);
+    double tof = (round_a * round_b - reply_a * reply_b) / (round_a + round_b + reply_a + reply_b);
+    double e_ab = 2.0 * (tof - calibration->tof_ab);
+
+    sit_welford_add(&calibration->e_a, e_a);
+    sit_welford_add(&calibration->e_b, e_b);
+    sit_welford_add(&calibration->e_ab, e_ab);
+    return true;
+}
+
+bool sit_calibration_solve(const sit_calibration_t *calibration, sit_calibration_result_t *result) {
+    uint32_t rounds = calibration->e_ab.n;
+    if (rounds < CONFIG_SIT_CALIBRATION_ROUNDS) {
+        return false;
+    }
+    /*
+     * min (d_a - e_a)^2 + (d_b - e_b)^2 + (d_a + d_b - e_ab)^2
+     * normal equations [2 1; 1 2] [d_a d_b]^T = [e_a + e_ab, e_b + e_ab]^T
+     */
+    double r_a = calibration->e_a.mean + calibration->e_ab.mean;
+    double r_b = calibration->e_b.mean + calibration->e_ab.mean;
+    double delay_a = (2.0 * r_a - r_b) / 3.0;
+    double delay_b = (2.0 * r_b - r_a) / 3.0;
+
+    // propagation of the standard errors of the means (assumed independent)
+    double var_a = sit_welford_variance(&calibration->e_a) / rounds;
+    double var_b = sit_welford_variance(&calibration->e_b) / rounds;
+    double var_ab = sit_welford_variance(&calibration->e_ab) / rounds;
+    result->std_a = (float)sqrt((4.0 * var_a + var_b + var_ab) / 9.0);
+    result->std_b = (float)sqrt((var_a + 4.0 * var_b + var_ab) / 9.0);
+
+    result->delay_a = (int16_t)lround(delay_a);
+    result->delay_b = (int16_t)lround(delay_b);
+    result->rounds = rounds;
+    return true;
+}
+
+/* Variance floor of a pair mean, a pair with identical samples gets no infinite weight */
+#define SIT_CALIBRATION_MIN_VARIANCE 1.0
+/* Relative pivot limit of the Cholesky decomposition */
+#define SIT_CALIBRATION_MIN_PIVOT 1e-9
+
+#define N SIT_CALIBRATION_MAX_DEVICES
+
+static double normal[N][N];
+static double chol[N][N];
+
+static int16_t pair_index(uint8_t devices, uint8_t a, uint8_t b) {
+    if (a == b || a >= devices || b >= devices) {
+        return -1;
+    }
+    if (a > b) {
+        uint8_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+    return a * (2 * devices - a - 1) / 2 + (b - a - 1);
+}
+
+bool sit_calibration_n_reset(sit_calibration_n_t *calibration, uint8_t devices) {
+    if (devices < 3 || devices > N) {
+        return false;
+    }
+    memset(calibration, 0, sizeof(*calibration));
+    calibration->devices = devices;
+    return true;
+}
+
+void sit_calibration_n_set_tof(sit_calibration_n_t *calibration, uint8_t a, uint8_t b, double tof) {
+    int16_t index = pair_index(calibration->devices, a, b);
+    if (index >= 0) {
+        calibration->tof[index] = (float)tof;
+    }
+}
+
+bool sit_calibration_n_add(sit_calibration_n_t *calibration, uint8_t a, uint8_t b, double tof) {
+    int16_t index = pair_index(calibration->devices, a, b);
+    if (index < 0 || calibration->tof[index] <= 0.0f) {
+        return false;
+    }
+    double error = 2.0 * (tof - calibration->tof[index]);
+    if (fabs(error) > SIT_CALIBRATION_MAX_ERROR) {
+        return false;
+    }
+    sit_welford_add(&calibration->error[index], error);
+    return true;
+}
+
+/* L L^T = normal, false if the matrix is not positive definite */
+static bool cholesky(uint8_t devices) {
+    double max_diagonal = 0.0;
+    for (uint8_t i = 0; i < devices; i++) {
+        max_diagonal = fmax(max_diagonal, normal[i][i]);
+    }
+    for (uint8_t j = 0; j < devices; j++) {
+        double pivot = normal[j][j];
+        for (uint8_t k = 0; k < j; k++) {
+            pivot -= chol[j][k] * chol[j][k];
+        }
+        if (pivot <= SIT_CALIBRATION_MIN_PIVOT * max_diagonal) {
+            return false;
+        }
+        chol[j][j] = sqrt(pivot);
+        for (uint8_t i = j + 1; i < devices; i++) {
+            double sum = normal[i][j];
+            for (uint8_t k = 0; k < j; k++) {
+                sum -= chol[i][k] * chol[j][k];
+            }
+            chol[i][j] = sum / chol[j][j];
+        }
+    }
+    return true;
+}
+
+/* Solve L L^T x = b in place */
+static void cholesky_solve(uint8_t devices, double *x) {
+    for (uint8_t i = 0; i < devices; i++) {
+        for (uint8_t k = 0; k < i; k++) {
+            x[i] -= chol[i][k] * x[k];
+        }
+        x[i] /= chol[i][i];
+    }
+    for (int8_t i = devices - 1; i >= 0; i--) {
+        for (uint8_t k = i + 1; k < devices; k++) {
+            x[i] -= chol[k][i] * x[k];
+        }
+        x[i] /= chol[i][i];
+    }
+}
+
+bool sit_calibration_n_solve(
+    const sit_calibration_n_t *calibration,
+    uint32_t min_rounds,
+    sit_calibration_n_result_t *result
+) {
+    uint8_t devices = calibration->devices;
+    double rhs[N] = {0};
+    memset(normal, 0, sizeof(normal));
+    memset(result, 0, sizeof(*result));
+    result->rounds = UINT32_MAX;
+    if (min_rounds < 2) {
+        min_rounds = 2;
+    }
+
+    /*
+     * min sum w_ij (d_i + d_j - e_ij)^2 with w_ij = n_ij / var_ij
+     * normal equations: (sum w_ij a_ij a_ij^T) d = sum w_ij e_ij a_ij
+     */
+    for (uint8_t a = 0; a < devices; a++) {
+        for (uint8_t b = a + 1; b < devices; b++) {
+            const sit_welford_t *error = &calibration->error[pair_index(devices, a, b)];
+            if (error->n < min_rounds) {
+                continue;
+            }
+            double variance = fmax(sit_welford_variance(error), SIT_CALIBRATION_MIN_VARIANCE);
+            double weight = error->n / variance;
+            normal[a][a] += weight;
+            normal[b][b] += weight;
+            normal[a][b] += weight;
+            normal[b][a] += weight;
+            rhs[a] += weight * error->mean;
+            rhs[b] += weight * error->mean;
+            result->pairs++;
+            result->rounds = error->n < result->rounds ? error->n : result->rounds;
+        }
+    }
+    if (result->pairs < devices || !cholesky(devices)) {
+        return false;
+    }
+    cholesky_solve(devices, rhs);
+
+    // residuals, the standard errors are scaled if they are larger than the noise
+    double sum = 0.0, chi2 = 0.0;
+    for (uint8_t a = 0; a < devices; a++) {
+        for (uint8_t b = a + 1; b < devices; b++) {
+            const sit_welford_t *error = &calibration->error[pair_index(devices, a, b)];
+            if (error->n < min_rounds) {
+                continue;
+            }
+            double residual = rhs[a] + rhs[b] - error->mean;
+            double variance = fmax(sit_welford_variance(error), SIT_CALIBRATION_MIN_VARIANCE);
+            sum += residual * residual;
+            chi2 += residual * residual * error->n / variance;
+        }
+    }
+    double scale = result->pairs > devices ? chi2 / (result->pairs - devices) : 1.0;
+    scale = fmax(scale, 1.0);
+
+    for (uint8_t i = 0; i < devices; i++) {
+        // diagonal of the inverse normal matrix
+        double column[N] = {0};
+        column[i] = 1.0;
+        cholesky_solve(devices, column);
+        result->std[i] = (float)sqrt(column[i] * scale);
+        result->delay[i] = (int16_t)lround(rhs[i]);
+    }
+    result->rms = (float)sqrt(sum / result->pairs);
+    return true;
+}
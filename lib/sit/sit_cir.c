@@ -0,0 +1,198 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_cir.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the CIR capture and streaming mode.
+ *
+ * Every accumulator sample has 6 bytes: 18 bit real and 18 bit imaginary
+ * part (3 bytes little endian each). The window is read in blocks of
+ * CONFIG_SIT_CIR_BLOCK_TAPS, with CONFIG_DW3000_SPI_ASYNC the next block is
+ * transferred while the last one is compressed.
+ *
+ * @bug No known bugs.
+ */
+
+#include <stddef.h>
+#include <errno.h>
+
+#include "sit/sit_cir.h"
+#include "sit/sit_diagnostic.h"
+
+#include <sit_ble/ble_init.h>
+#include <deca_device_api.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_CIR, LOG_LEVEL_INF);
+
+#define CIR_SAMPLE_BYTES     6
+#define CIR_BLOCK_TAPS       CONFIG_SIT_CIR_BLOCK_TAPS
+#define CIR_MAX_FRAGMENTS    ((CONFIG_SIT_CIR_TAPS + CIR_BLOCK_TAPS - 1) / CIR_BLOCK_TAPS)
+#define CIR_RAW_LEN          (CIR_BLOCK_TAPS * CIR_SAMPLE_BYTES + 1) // + dummy byte
+#define CIR_RETRY_MS         10 // BLE buffers full
+#define CIR_REPORT_STREAMS   10
+
+static sit_cir_fragment_t fragments[CIR_MAX_FRAGMENTS];
+static uint16_t fragment_count;
+static uint16_t fragment_next;
+static uint16_t last_taps; // taps in the last fragment
+
+static uint8_t raw[2][CIR_RAW_LEN];
+#ifdef CONFIG_DW3000_SPI_ASYNC
+static struct k_poll_signal raw_signal;
+#endif
+
+static atomic_t streaming;
+static sit_cir_stats_t stats;
+static uint32_t frame_counter;
+static int64_t report_start;
+static uint32_t report_streamed;
+
+static void stream_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(stream_work, stream_handler);
+
+/* Block floating point: one shift for all samples of the block */
+static void compress_block(const uint8_t *data, uint16_t taps, sit_cir_fragment_t *fragment) {
+    int32_t max_abs = 0;
+    for (uint16_t i = 0; i < 2 * taps; i++) {
+        int32_t value = accum_sample(&data[i * 3]);
+        max_abs = MAX(max_abs, value < 0 ? -value : value);
+    }
+    int8_t exponent = 0;
+    while ((max_abs >> exponent) > INT16_MAX) {
+        exponent++;
+    }
+    for (uint16_t i = 0; i < 2 * taps; i++) {
+        fragment->iq[i] = (int16_t)(accum_sample(&data[i * 3]) >> exponent);
+    }
+    fragment->exponent = exponent;
+}
+
+static void read_window(uint16_t first_tap) {
+    for (uint16_t block = 0; block < fragment_count; block++) {
+        uint16_t block_taps = (block + 1 == fragment_count) ? last_taps : CIR_BLOCK_TAPS;
+        uint16_t length = block_taps * CIR_SAMPLE_BYTES + 1;
+        uint8_t *buffer = raw[block % 2];
+        #ifdef CONFIG_DW3000_SPI_ASYNC
+            if (block == 0) {
+                read_accumulator_async(buffer, length, first_tap, &raw_signal);
+            }
+            if (wait_accumulator(&raw_signal)) {
+                LOG_ERR("CIR block %u read failed", block);
+            }
+            if (block + 1 < fragment_count) {
+                uint16_t next_taps = (block + 2 == fragment_count) ? last_taps : CIR_BLOCK_TAPS;
+                read_accumulator_async(raw[(block + 1) % 2], next_taps * CIR_SAMPLE_BYTES + 1,
+                    first_tap + (block + 1) * CIR_BLOCK_TAPS, &raw_signal);
+            }
+        #else
+            dwt_readaccdata(buffer, length, first_tap + block * CIR_BLOCK_TAPS);
+        #endif
+        fragments[block].first_tap = first_tap + block * CIR_BLOCK_TAPS;
+        compress_block(&buffer[1], block_taps, &fragments[block]);
+    }
+}
+
+bool sit_cir_capture(uint32_t sequence) {
+    frame_counter++;
+    if (frame_counter % CONFIG_SIT_CIR_EVERY != 0) {
+        return false;
+    }
+    if (atomic_get(&streaming) || !is_connected()) {
+        stats.skipped++;
+        return false;
+    }
+    #ifdef CONFIG_DW3000_SPI_ASYNC
+        k_poll_signal_init(&raw_signal);
+    #endif
+
+    uint32_t start = k_cycle_get_32();
+    dwt_rxdiag_t rx_diag;
+    dwt_readdiagnostics(&rx_diag);
+    uint16_t fp_tap = rx_diag.ipatovFpIndex >> 6;
+    uint16_t first_tap = fp_tap > CONFIG_SIT_CIR_PRE_TAPS ? fp_tap - CONFIG_SIT_CIR_PRE_TAPS : 0;
+    uint16_t taps = MIN(CONFIG_SIT_CIR_TAPS, SIT_CIR_ACCUM_TAPS - first_tap);
+
+    fragment_count = (taps + CIR_BLOCK_TAPS - 1) / CIR_BLOCK_TAPS;
+    last_taps = taps - (fragment_count - 1) * CIR_BLOCK_TAPS;
+    read_window(first_tap);
+    stats.capture_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    stats.captures++;
+    for (uint16_t i = 0; i < fragment_count; i++) {
+        fragments[i].type = SIT_CIR_FRAGMENT_TYPE;
+        fragments[i].fragment = i;
+        fragments[i].fragments = fragment_count;
+        fragments[i].capture = (uint16_t)stats.captures;
+        fragments[i].fp_index = rx_diag.ipatovFpIndex;
+        fragments[i].sequence = sequence;
+    }
+    if (report_start == 0) {
+        report_start = k_uptime_get();
+    }
+    fragment_next = 0;
+    atomic_set(&streaming, 1);
+    k_work_reschedule(&stream_work, K_NO_WAIT);
+    return true;
+}
+
+static void stream_done(void) {
+    stats.streamed++;
+    report_streamed++;
+    atomic_set(&streaming, 0);
+    if (report_streamed == CIR_REPORT_STREAMS) {
+        int64_t elapsed = k_uptime_get() - report_start;
+        uint32_t rate = (uint32_t)(report_streamed * 100000 / MAX(elapsed, 1));
+        LOG_INF("CIR: %u.%02u per s, read %u us, %u skipped",
+            rate / 100, rate % 100, stats.capture_us, stats.skipped);
+        report_start = k_uptime_get();
+        report_streamed = 0;
+    }
+}
+
+static void stream_handler(struct k_work *work) {
+    if (!is_connected()) {
+        atomic_set(&streaming, 0);
+        return;
+    }
+    uint16_t taps = (fragment_next + 1 == fragment_count) ? last_taps : CIR_BLOCK_TAPS;
+    size_t length = offsetof(sit_cir_fragment_t, iq) + taps * 2 * sizeof(int16_t);
+    int err = ble_sit_cir_notify(&fragments[fragment_next], length);
+    if (err == -ENOMEM) {
+        k_work_reschedule(&stream_work, K_MSEC(CIR_RETRY_MS));
+        return;
+    } else if (err) {
+        LOG_WRN("CIR fragment %u not sent (err %d)", fragment_next, err);
+    }
+    fragment_next++;
+    if (fragment_next == fragment_count) {
+        stream_done();
+    } else {
+        k_work_reschedule(&stream_work, K_NO_WAIT);
+    }
+}
+
+void sit_cir_get_stats(sit_cir_stats_t *stats_out) {
+    *stats_out = stats;
+}
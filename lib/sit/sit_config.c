@@ -31,6 +31,12 @@
  */
 
 #include "sit/sit_config.h"
+#ifdef CONFIG_SIT_SETTINGS
+    #include "sit/sit_settings.h"
+#endif
+#ifdef CONFIG_SIT_TEMP_COMP
+    #include "sit/sit_temp.h"
+#endif
 
 #include <deca_device_api.h>
 
@@ -51,6 +57,8 @@ device_settings_t device_settings = {
     .diagnostic = false,
     .min_measurement = 0,
     .max_measurement = 0,
+    .ant_dly_temp_coeff = 0.0f,
+    .xtal_trim = 0,
 };
 
 dwt_config_t sit_device_config = {
@@ -81,9 +89,12 @@ void set_device_state(char *command) {
     }
 }
 
-void set_device_id(uint8_t device_id) {
+void set_device_id(sit_addr_t device_id) {
     device_settings.deviceID = device_id;
     LOG_INF("Device ID: %d", device_settings.deviceID);
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
 }
 
 void set_device_type(char *type) {
@@ -100,10 +111,16 @@ void set_device_type(char *type) {
     } else {
         LOG_ERR("Wrong device type");
     }
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
 }
 
-void set_responder(uint8_t responder) {
+void set_responder(sit_addr_t responder) {
     device_settings.responder = responder;
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
 }
 
 void set_min_measurement(uint32_t measurement) {
@@ -122,18 +139,65 @@ void set_measurement_type(char *measurement_type) {
         device_settings.measurement_type = ds_3_twr;
     } else if (strcmp(measurement_type, "two_device") == 0) {
         device_settings.measurement_type = two_device_calibration;
+    } else if (strcmp(measurement_type, "survey") == 0) {
+        device_settings.measurement_type = anchor_survey;
+    } else if (strcmp(measurement_type, "compare") == 0) {
+        device_settings.measurement_type = twr_compare;
+    } else if (strcmp(measurement_type, "ds_all_twr") == 0) {
+        device_settings.measurement_type = ds_all_twr;
+    } else if (strcmp(measurement_type, "ext_cali") == 0) {
+        device_settings.measurement_type = extended_calibration;
     }
     else {
         LOG_ERR("Wrong measurement type");
     }
     
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
 }
 
 void set_rx_ant_dly(uint16_t dly) {
     device_settings.rx_ant_dly = dly;
-    dwt_setrxantennadelay(dly);
+    #ifdef CONFIG_SIT_TEMP_COMP
+        // with the offset of the current temperature
+        sit_temp_apply();
+    #else
+        dwt_setrxantennadelay(dly);
+    #endif
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
 }
 void set_tx_ant_dly(uint16_t dly) {
     device_settings.tx_ant_dly = dly;
-    dwt_settxantennadelay(dly);
-}
\ No newline at end of file
+    #ifdef CONFIG_SIT_TEMP_COMP
+        sit_temp_apply();
+    #else
+        dwt_settxantennadelay(dly);
+    #endif
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
+}
+
+void set_calibration_distance(float distance_ab, float distance_ac, float distance_bc) {
+    device_settings.calibration_distance[0] = distance_ab;
+    device_settings.calibration_distance[1] = distance_ac;
+    device_settings.calibration_distance[2] = distance_bc;
+}
+
+void set_ant_dly_temp_coeff(float coeff) {
+    device_settings.ant_dly_temp_coeff = coeff;
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
+}
+
+void set_xtal_trim(uint8_t trim) {
+    device_settings.xtal_trim = trim;
+    dwt_setxtaltrim(trim);
+    #ifdef CONFIG_SIT_SETTINGS
+        sit_settings_save();
+    #endif
+}
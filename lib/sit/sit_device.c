@@ -29,6 +29,7 @@
  * @todo everything 
  */
 #include "sit/sit_device.h"
+#include "sit/sit_config.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -114,4 +115,16 @@ void init_device_id(void) {
 
 void get_device_id(char **deviceID) {
     *deviceID = strdup(m_deviceID);
+}
+
+uint16_t get_tag_address(void) {
+    uint8_t buf_deviceID[8] = {0};
+    hwinfo_get_device_id(buf_deviceID, sizeof(buf_deviceID));
+
+    // FNV-1a over the hardware id
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < sizeof(buf_deviceID); i++) {
+        hash = (hash ^ buf_deviceID[i]) * 16777619u;
+    }
+    return 1 + hash % SIT_TAG_ADDR_MAX;
 }
\ No newline at end of file
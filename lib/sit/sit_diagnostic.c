@@ -4,6 +4,14 @@
 #include "sit/sit_config.h"
 #include <deca_device_api.h>
 
+#ifdef CONFIG_DW3000_SPI_ASYNC
+#include <dw3000_spi.h>
+#endif
+#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+#include "sit/sit_nlos.h"
+#endif
+
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(SIT_DIAGNOSTIC, LOG_LEVEL_INF);
 
@@ -23,6 +31,92 @@ static dwt_rxdiag_t rx_diag;
 dwt_nlos_alldiag_t diag_data;
 dwt_nlos_ipdiag_t fp_pp_index; 
 
+#define ACCUM_SAMPLE_SIGN_BIT (1 << 17)
+
+int32_t accum_sample(const uint8_t *data) {
+    int32_t value = (int32_t)data[0] | ((int32_t)data[1] << 8) | ((int32_t)(data[2] & 0x03) << 16);
+    return (value & ACCUM_SAMPLE_SIGN_BIT) ? value - (ACCUM_SAMPLE_SIGN_BIT << 1) : value;
+}
+
+#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+#define NLOS_CIR_LEN        (CONFIG_SIT_NLOS_CIR_TAPS * 6 + 1)
+#define NLOS_CIR_PRE_TAPS   4
+#define NLOS_REPORT_FRAMES  100
+#define NLOS_MAX_US         100 // CIR read (~50 us at 36 MHz SPI) and inference
+
+static sit_nlos_model_t nlos_model;
+static bool nlos_model_loaded = false;
+static uint8_t nlos_cir_raw[NLOS_CIR_LEN];
+static int16_t nlos_cir[2 * CONFIG_SIT_NLOS_CIR_TAPS];
+static int32_t nlos_features[SIT_NLOS_FEATURES];
+static bool nlos_pending = false;
+static uint32_t nlos_read_cycles;
+static uint32_t nlos_frames;
+static uint32_t nlos_cycles;
+static uint32_t nlos_max_cycles;
+
+void set_nlos_model(const float *mean, const float *scale, const float *weight, float bias) {
+    sit_nlos_model_from_float(&nlos_model, mean, scale, weight, bias);
+    nlos_model_loaded = true;
+    LOG_INF("NLOS model loaded");
+}
+
+/* Register and accumulator reads, before the next frame overwrites the CIR */
+static void read_nlos_inputs(float rsl_fpl, int32_t *features) {
+    uint32_t start = k_cycle_get_32();
+    dwt_nlos_ipdiag(&fp_pp_index);
+    features[nlos_fp_pp] = ((int32_t)fp_pp_index.index_pp_u32 - (int32_t)fp_pp_index.index_fp_u32) << 2;
+    features[nlos_rsl_fpl] = (int32_t)(rsl_fpl * SIT_NLOS_ONE);
+    features[nlos_dgc] = (int32_t)dwt_get_dgcdecision() << SIT_NLOS_Q;
+
+    uint32_t fp_tap = fp_pp_index.index_fp_u32 >> 6;
+    uint16_t first_tap = fp_tap > NLOS_CIR_PRE_TAPS ? fp_tap - NLOS_CIR_PRE_TAPS : 0;
+    dwt_readaccdata(nlos_cir_raw, NLOS_CIR_LEN, first_tap);
+    nlos_read_cycles = k_cycle_get_32() - start;
+}
+
+static uint8_t classify_nlos(int32_t *features) {
+    if (!nlos_model_loaded) {
+        sit_nlos_model_default(&nlos_model);
+        nlos_model_loaded = true;
+    }
+    uint32_t start = k_cycle_get_32();
+    for (uint16_t i = 0; i < 2 * CONFIG_SIT_NLOS_CIR_TAPS; i++) {
+        // 18 bit to int16
+        nlos_cir[i] = (int16_t)(accum_sample(&nlos_cir_raw[1 + i * 3]) >> 2);
+    }
+    sit_nlos_cir_features(nlos_cir, CONFIG_SIT_NLOS_CIR_TAPS, features);
+    uint16_t probability = sit_nlos_probability(&nlos_model, features);
+    // per frame cost: accumulator read and inference
+    uint32_t cycles = nlos_read_cycles + (k_cycle_get_32() - start);
+
+    nlos_cycles += cycles;
+    nlos_max_cycles = MAX(nlos_max_cycles, cycles);
+    if (++nlos_frames == NLOS_REPORT_FRAMES) {
+        uint32_t mean_us = k_cyc_to_us_floor32(nlos_cycles / nlos_frames);
+        uint32_t max_us = k_cyc_to_us_floor32(nlos_max_cycles);
+        if (max_us > NLOS_MAX_US) {
+            LOG_WRN("NLOS CIR read + inference: mean %u us, max %u us > %u us", mean_us, max_us, NLOS_MAX_US);
+        } else {
+            LOG_INF("NLOS CIR read + inference: mean %u us, max %u us", mean_us, max_us);
+        }
+        nlos_frames = 0;
+        nlos_cycles = 0;
+        nlos_max_cycles = 0;
+    }
+    return (uint8_t)((uint32_t)probability * 100 / SIT_NLOS_PROB_ONE);
+}
+
+void sit_diagnostic_classify(diagnostic_info *diagnostic) {
+    if (!nlos_pending) {
+        return;
+    }
+    nlos_pending = false;
+    diagnostic->nlos = classify_nlos(nlos_features);
+    LOG_INF("NLOS probability: %u%%", diagnostic->nlos);
+}
+#endif
+
 void get_fp_pp_index(void) {
     dwt_nlos_ipdiag(&fp_pp_index);
     dwt_readdiagnostics(&rx_diag);
@@ -71,6 +165,11 @@ void get_diagnostic(diagnostic_info *diagnostic) {
     LOG_INF("Recived Index: %f", ip_rsl);
     LOG_INF("First Path Index: %f", ip_fsl);
 
+#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+    // the inference runs later in sit_diagnostic_classify(), off the reply path
+    read_nlos_inputs(ip_rsl - ip_fsl, nlos_features);
+    nlos_pending = true;
+#else
     // If differenc is bigger than 12 db the singal is Non Line of Sight
     if ((ip_rsl - ip_fsl) > 12 ) {
         LOG_INF("non line of sight"); 
@@ -79,7 +178,54 @@ void get_diagnostic(diagnostic_info *diagnostic) {
         LOG_INF("line of sight");
         diagnostic->nlos = 0;
     }
+#endif
 
     diagnostic->fpi = ip_fsl;
     diagnostic->rssi = ip_rsl;
-}
\ No newline at end of file
+}
+#ifdef CONFIG_DW3000_SPI_ASYNC
+#define BENCHMARK_ACCUM_LEN  (1024 + 1) // 1 KB accumulator data + dummy byte
+#define BENCHMARK_RUNS       10
+#define ASYNC_READ_TIMEOUT   K_MSEC(10)
+
+static uint8_t benchmark_data[BENCHMARK_ACCUM_LEN];
+static struct k_poll_signal accum_signal;
+
+void read_accumulator_async(uint8_t *buffer, uint16_t length, uint16_t offset, struct k_poll_signal *signal) {
+    // dwt_readaccdata first sets the indirect pointer (short, blocking writes),
+    // only the data read itself is deferred
+    dw3000_spi_read_defer(length, signal);
+    dwt_readaccdata(buffer, length, offset);
+}
+
+int wait_accumulator(struct k_poll_signal *signal) {
+    return dw3000_spi_read_wait(signal, ASYNC_READ_TIMEOUT);
+}
+
+void spi_read_benchmark(void) {
+    uint32_t sync_cycles = 0;
+    uint32_t busy_cycles = 0;
+    uint32_t transfer_cycles = 0;
+
+    k_poll_signal_init(&accum_signal);
+    for (uint8_t run = 0; run < BENCHMARK_RUNS; run++) {
+        uint32_t start = k_cycle_get_32();
+        dwt_readaccdata(benchmark_data, BENCHMARK_ACCUM_LEN, 0);
+        sync_cycles += k_cycle_get_32() - start;
+
+        start = k_cycle_get_32();
+        read_accumulator_async(benchmark_data, BENCHMARK_ACCUM_LEN, 0, &accum_signal);
+        busy_cycles += k_cycle_get_32() - start;
+        if (wait_accumulator(&accum_signal)) {
+            LOG_ERR("Async accumulator read failed");
+            return;
+        }
+        transfer_cycles += k_cycle_get_32() - start;
+    }
+
+    LOG_INF("Accumulator read %u bytes, mean of %u runs", BENCHMARK_ACCUM_LEN, BENCHMARK_RUNS);
+    LOG_INF("Blocking: %u us", k_cyc_to_us_floor32(sync_cycles / BENCHMARK_RUNS));
+    LOG_INF("Async transfer: %u us", k_cyc_to_us_floor32(transfer_cycles / BENCHMARK_RUNS));
+    LOG_INF("Async CPU busy: %u us", k_cyc_to_us_floor32(busy_cycles / BENCHMARK_RUNS));
+}
+#endif
@@ -0,0 +1,126 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_discovery.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the anchor discovery.
+ *
+ * A polled anchor does not send beacons, its entry is refreshed by the
+ * successful ranges. The beacon period gets a jitter of up to a quarter
+ * period, so anchors which start together do not collide every time.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_discovery.h"
+#include "sit/sit_config.h"
+#include "sit/sit_distance.h"
+
+#include <math.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/random/random.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_DISCOVERY, LOG_LEVEL_INF);
+
+#define SIT_DISCOVERY_BROADCAST SIT_ADDR_BROADCAST
+
+static sit_responder_table_t table;
+static int64_t last_poll;
+static int64_t next_beacon;
+static uint16_t beacon_sequence;
+
+static uint32_t now_ms(void) {
+	return (uint32_t)k_uptime_get();
+}
+
+static int64_t beacon_period(void) {
+	return CONFIG_SIT_DISCOVERY_BEACON_MS + sys_rand32_get() % (CONFIG_SIT_DISCOVERY_BEACON_MS / 4 + 1);
+}
+
+void sit_discovery_reset(void) {
+	sit_responder_table_reset(&table);
+	last_poll = 0;
+	next_beacon = 0;
+}
+
+uint32_t sit_discovery_rx_timeout(void) {
+	return CONFIG_SIT_DISCOVERY_BEACON_MS * 1000;
+}
+
+void sit_discovery_responder(bool polled) {
+	int64_t now = k_uptime_get();
+	if (polled) {
+		last_poll = now;
+		return;
+	}
+	if (now - last_poll < CONFIG_SIT_DISCOVERY_BEACON_MS || now < next_beacon) {
+		return;
+	}
+	msg_simple_t beacon = {{anchor_beacon, beacon_sequence++, device_settings.deviceID, SIT_DISCOVERY_BROADCAST}, 0};
+	sit_send_now((uint8_t*)&beacon, sizeof(beacon));
+	next_beacon = now + beacon_period();
+}
+
+uint16_t sit_discovery_responders(uint16_t *addresses) {
+	uint16_t before = table.count;
+	uint16_t removed = sit_responder_table_age(&table, now_ms(), CONFIG_SIT_DISCOVERY_TIMEOUT_MS);
+	if (removed > 0) {
+		LOG_INF("%u of %u anchors lost", removed, before);
+	}
+	for (uint16_t i = 0; i < table.count; i++) {
+		addresses[i] = table.address[i];
+	}
+	return table.count;
+}
+
+void sit_discovery_update(uint16_t address, bool success, double distance, double clock_offset) {
+	int16_t index = sit_responder_table_find(&table, address);
+	if (index < 0) {
+		return;
+	}
+	int32_t distance_mm = distance < 0.0 ? INT32_MIN : (int32_t)lround(distance * 1000);
+	int16_t offset = (int16_t)CLAMP(lround(clock_offset * 1e8), INT16_MIN, INT16_MAX);
+	sit_responder_table_update(&table, index, success, distance_mm, offset, now_ms());
+}
+
+void sit_discovery_listen(void) {
+	int64_t end = k_uptime_get() + CONFIG_SIT_DISCOVERY_LISTEN_MS;
+	int64_t remaining = CONFIG_SIT_DISCOVERY_LISTEN_MS;
+	while (remaining > 0) {
+		msg_simple_t beacon;
+		sit_receive_now(0, (uint32_t)remaining * 1000);
+		if (sit_check_any_msg((uint8_t*)&beacon, sizeof(beacon)) && beacon.header.id == anchor_beacon) {
+			bool known = sit_responder_table_find(&table, beacon.header.source) >= 0;
+			if (sit_responder_table_seen(&table, beacon.header.source, now_ms()) < 0) {
+				LOG_WRN("Responder table full, anchor %u ignored", beacon.header.source);
+			} else if (!known) {
+				LOG_INF("Anchor %u discovered (%u anchors)", beacon.header.source, table.count);
+			}
+		}
+		remaining = end - k_uptime_get();
+	}
+}
+
+const sit_responder_table_t *sit_discovery_table(void) {
+	return &table;
+}
@@ -36,14 +36,25 @@
 #ifdef CONFIG_SIT_DIAGNOSTIC
 	#include "sit/sit_diagnostic.h"
 #endif
+#ifdef CONFIG_SIT_POWER_SLEEP
+	#include "sit/sit_power.h"
+#endif
+#ifdef CONFIG_SIT_CCA
+	#include "sit/sit_backoff.h"
+#endif
 
 
 #include <deca_device_api.h>
 
+#include <zephyr/kernel.h>
+#include <zephyr/random/random.h>
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(SIT_DISTANCE, LOG_LEVEL_INF);
 
 uint32_t status_reg;
+// preamble timeout of the next response, the CCA listens with its own
+static uint16_t response_preamble_timeout;
 
 diagnostic_info diagnostic; 
 
@@ -62,7 +73,78 @@ void sit_start_poll(uint8_t* msg_data, uint16_t msg_size){
 	dwt_writetxdata(msg_size, msg_data, 0); // 0 offset
 	dwt_writetxfctrl(msg_size, 0, 1); // frame_length, bufferOffset, ranging bit (0 no ranging, 1 ranging)
 	dwt_starttx(DWT_START_TX_IMMEDIATE | DWT_RESPONSE_EXPECTED);//switch to rx after `setrxaftertxdelay`
+	#ifdef CONFIG_SIT_POWER_SLEEP
+		sit_power_count_tx();
+	#endif
+}
+
+#ifdef CONFIG_SIT_CCA
+#define CCA_REPORT_POLLS 100
+
+static sit_backoff_stats_t cca_stats;
+
+static void cca_report() {
+	if (cca_stats.polls % CCA_REPORT_POLLS != 0) {
+		return;
+	}
+	LOG_INF("CCA: %u polls, %u busy, %u retries, %u dropped, %u without response, mean backoff %u us",
+		cca_stats.polls, cca_stats.busy, cca_stats.retries, cca_stats.dropped, cca_stats.no_response,
+		cca_stats.backoff_periods * CONFIG_SIT_CCA_BACKOFF_US / cca_stats.polls);
+}
+
+/* 
+ * The DW3000 listens for the preamble detection timeout before the 
+ * transmission and cancels it if it detects a preamble (CCA_FAIL). The 
+ * CCA uses CONFIG_SIT_CCA_TIMEOUT_PACS, the response timeout is restored 
+ * after the transmission, before the receiver is enabled for the response.
+ */
+bool sit_start_poll_cca(uint8_t* msg_data, uint16_t msg_size){
+	sit_backoff_t backoff;
+	int32_t periods = (int32_t)sit_backoff_start(&backoff, &cca_stats, sys_rand32_get());
+	while (periods >= 0) {
+		if (periods > 0) {
+			k_usleep(periods * CONFIG_SIT_CCA_BACKOFF_US);
+		}
+		dwt_writesysstatuslo(DWT_INT_TXFRS_BIT_MASK);
+		dwt_writesysstatushi(DWT_INT_HI_CCA_FAIL_BIT_MASK);
+		dwt_writetxdata(msg_size, msg_data, 0);
+		dwt_writetxfctrl(msg_size, 0, 1);
+		dwt_setpreambledetecttimeout(CONFIG_SIT_CCA_TIMEOUT_PACS);
+		if (dwt_starttx(DWT_START_TX_CCA | DWT_RESPONSE_EXPECTED) == DWT_SUCCESS) {
+			uint32_t hi_status = 0;
+			waitforsysstatus(NULL, &hi_status, DWT_INT_TXFRS_BIT_MASK, DWT_INT_HI_CCA_FAIL_BIT_MASK);
+			if (!(hi_status & DWT_INT_HI_CCA_FAIL_BIT_MASK)) {
+				dwt_setpreambledetecttimeout(response_preamble_timeout);
+				#ifdef CONFIG_SIT_POWER_SLEEP
+					sit_power_count_tx();
+				#endif
+				cca_report();
+				return true;
+			}
+			dwt_writesysstatushi(DWT_INT_HI_CCA_FAIL_BIT_MASK);
+		}
+		dwt_forcetrxoff();
+		periods = sit_backoff_busy(&backoff, &cca_stats, sys_rand32_get());
+	}
+	LOG_WRN("Channel busy, poll dropped after %u backoffs", backoff.backoffs);
+	dwt_setpreambledetecttimeout(response_preamble_timeout);
+	cca_report();
+	return false;
+}
+
+void sit_cca_result(bool response) {
+	sit_backoff_result(&cca_stats, response);
+}
+
+const sit_backoff_stats_t *sit_cca_stats() {
+	return &cca_stats;
 }
+#else
+bool sit_start_poll_cca(uint8_t* msg_data, uint16_t msg_size){
+	sit_start_poll(msg_data, msg_size);
+	return true;
+}
+#endif
 
 bool sit_send_at(uint8_t* msg_data, uint16_t size, uint32_t tx_time){
 	dwt_writetxdata(size, msg_data, 0); 
@@ -70,6 +152,13 @@ bool sit_send_at(uint8_t* msg_data, uint16_t size, uint32_t tx_time){
 	dwt_setdelayedtrxtime(tx_time);
 	uint8_t ret = dwt_starttx(DWT_START_TX_DELAYED);
 	if(ret == DWT_SUCCESS) {
+		#ifdef CONFIG_SIT_POWER_SLEEP
+			sit_power_count_tx();
+		#endif
+		#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+			// the reply is scheduled, classify the received frame while the TX is pending
+			sit_diagnostic_classify(&diagnostic);
+		#endif
 		waitforsysstatus(&status_reg, NULL, DWT_INT_TXFRS_BIT_MASK, 0);
 		dwt_writesysstatuslo(DWT_INT_RXFCG_BIT_MASK); // write to clear send status bit
 		LOG_INF("Send Success");
@@ -88,6 +177,13 @@ bool sit_send_at_with_response(uint8_t* msg_data, uint16_t size, uint32_t tx_tim
 	dwt_writetxfctrl(size, 0, 1); 
 	uint8_t ret = dwt_starttx(DWT_START_TX_DELAYED | DWT_RESPONSE_EXPECTED);
 	if(ret == DWT_SUCCESS) {
+		#ifdef CONFIG_SIT_POWER_SLEEP
+			sit_power_count_tx();
+		#endif
+		#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+			// the reply is scheduled, classify the received frame while the TX is pending
+			sit_diagnostic_classify(&diagnostic);
+		#endif
 		waitforsysstatus(&status_reg, NULL, DWT_INT_TXFRS_BIT_MASK, 0);
 		dwt_writesysstatuslo(DWT_INT_RXFCG_BIT_MASK); // write to clear send status bit
 		LOG_INF("Send Success");
@@ -100,6 +196,24 @@ bool sit_send_at_with_response(uint8_t* msg_data, uint16_t size, uint32_t tx_tim
 	}
 }
 
+bool sit_send_now(uint8_t* msg_data, uint16_t size){
+	dwt_writetxdata(size, msg_data, 0); 
+	dwt_writetxfctrl(size, 0, 0); 
+	uint8_t ret = dwt_starttx(DWT_START_TX_IMMEDIATE);
+	if(ret == DWT_SUCCESS) {
+		#ifdef CONFIG_SIT_POWER_SLEEP
+			sit_power_count_tx();
+		#endif
+		waitforsysstatus(&status_reg, NULL, DWT_INT_TXFRS_BIT_MASK, 0);
+		dwt_writesysstatuslo(DWT_INT_TXFRS_BIT_MASK);
+		return true;
+	} else {
+		recover_tx_errors();
+		LOG_WRN("sit_send_now() - dwt_starttx() failed");
+		return false;
+	}
+}
+
 void sit_receive_now(uint16_t preamble_detction_timeout, uint32_t rx_timeout) {
 	dwt_setpreambledetecttimeout(preamble_detction_timeout);
 	dwt_setrxtimeout(rx_timeout);
@@ -111,10 +225,15 @@ void sit_receive_now(uint16_t preamble_detction_timeout, uint32_t rx_timeout) {
 	}
 }
 
-void sit_receive_at(uint32_t timeout) {
+bool sit_receive_at(uint32_t timeout) {
 	dwt_setpreambledetecttimeout(0);
 	dwt_setrxtimeout(timeout); // 0 : disable timeout
-	dwt_rxenable(DWT_START_RX_DELAYED | DWT_IDLE_ON_DLY_ERR); //DWT_START_RX_DELAYED only used with dwt_setdelayedtrxtime() before 
+	int ret = dwt_rxenable(DWT_START_RX_DELAYED | DWT_IDLE_ON_DLY_ERR); //DWT_START_RX_DELAYED only used with dwt_setdelayedtrxtime() before 
+	if (ret != DWT_SUCCESS) {
+		LOG_WRN("sit_receive_at() - dwt_rxenable() late");
+		return false;
+	}
+	return true;
 }
 
 uint32_t sit_msg_receive() {
@@ -153,6 +272,28 @@ bool sit_check_msg(uint8_t* data, uint16_t expected_frame_length) {
 	return result;
 }
 
+bool sit_check_any_msg(uint8_t* data, uint16_t max_length) {
+	bool result = false;
+	status_reg = sit_msg_receive();
+	if(status_reg & DWT_INT_RXFCG_BIT_MASK) {
+		dwt_writesysstatuslo(DWT_INT_RXFCG_BIT_MASK);
+		uint16_t frame_length = dwt_getframelength();
+		if (frame_length >= sizeof(header_t) && frame_length <= max_length) {
+			dwt_readrxdata(data, frame_length, 0);
+			#ifdef CONFIG_SIT_DIAGNOSTIC
+				get_diagnostic(&diagnostic);
+			#endif
+			result = true;
+		} else {
+			LOG_ERR("RX Frame Length: %u > Max Frame Length: %u",frame_length, max_length);
+		}
+	} else {
+		dwt_writesysstatuslo(SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+		dwt_forcetrxoff();
+	}
+	return result;
+}
+
 bool sit_check_msg_id(msg_id_t id, msg_simple_t* message) {
 	bool result = false;
 	if(sit_check_msg((uint8_t*)message, sizeof(msg_simple_t))){
@@ -196,6 +337,20 @@ bool sit_check_ds_final_msg_id(msg_id_t id, msg_ds_twr_final_t* message) {
 	return result;
 }
 
+bool sit_check_ds_report_msg_id(msg_id_t id, msg_ds_twr_report_t* message) {
+	bool result = false;
+	if(sit_check_msg((uint8_t*)message, sizeof(msg_ds_twr_report_t))){
+		if(message->header.id == id) {
+			result = true;
+		} else {
+			LOG_ERR("sit_check_ds_report_msg_id() mismatch id(%u/%u)",(uint8_t)id,(uint8_t)message->header.id);
+		}
+	} else {
+		LOG_ERR("sit_check_ds_report_msg_id(%u,header) fail",(uint8_t)id);
+	}
+	return result;
+}
+
 bool sit_check_sensing_3_msg_id(msg_id_t id, msg_sensing_3_t * message){
 	bool result = false;
 	if(sit_check_msg((uint8_t*)message, sizeof(msg_sensing_3_t))){
@@ -224,6 +379,34 @@ bool sit_check_sensing_info_msg_id(msg_id_t id, msg_sensing_info_t * message){
 	return result;
 }
 
+bool sit_check_survey_report_msg_id(msg_id_t id, msg_survey_report_t * message){
+	bool result = false;
+	if(sit_check_msg((uint8_t*)message, sizeof(msg_survey_report_t))){
+		if(message->header.id == id) {
+			result = true;
+		} else {
+			LOG_ERR("sit_check_survey_report_msg_id() mismatch id(%u/%u)",(uint8_t)id,(uint8_t)message->header.id);
+		}
+	} else {
+		LOG_ERR("sit_check_survey_report_msg_id(%u,header) fail",(uint8_t)id);
+	}
+	return result;
+}
+
+bool sit_check_calibration_result_msg_id(msg_id_t id, msg_calibration_result_t * message){
+	bool result = false;
+	if(sit_check_msg((uint8_t*)message, sizeof(msg_calibration_result_t))){
+		if(message->header.id == id) {
+			result = true;
+		} else {
+			LOG_ERR("sit_check_calibration_result_msg_id() mismatch id(%u/%u)",(uint8_t)id,(uint8_t)message->header.id);
+		}
+	} else {
+		LOG_ERR("sit_check_calibration_result_msg_id(%u,header) fail",(uint8_t)id);
+	}
+	return result;
+}
+
 void sit_set_rx_tx_delay_and_rx_timeout(uint32_t delay_us, uint16_t timeout) {
 	dwt_setrxaftertxdelay(delay_us);
 	dwt_setrxtimeout(timeout);
@@ -238,6 +421,7 @@ void sit_set_rx_timeout(uint16_t timeout) {
 }
 
 void sit_set_preamble_detection_timeout(uint16_t timeout) {
+	response_preamble_timeout = timeout;
 	dwt_setpreambledetecttimeout(timeout);
 }
 
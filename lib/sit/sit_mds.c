@@ -0,0 +1,282 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_mds.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the anchor survey solver.
+ *
+ * 1. Missing distances are filled with the shortest path (Floyd-Warshall),
+ *    classical MDS needs a complete matrix.
+ * 2. Double centering B = -1/2 J D^2 J and power iteration with deflation
+ *    for the 2 or 3 largest eigenpairs, X = V * sqrt(lambda).
+ * 3. Refinement: every anchor is re-solved against all others with the
+ *    measured distances only, repeated SIT_MDS_REFINE_ROUNDS times.
+ * 4. The result is rotated into the local anchor frame.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_mds.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SIT_MDS_POWER_ITERATIONS 100
+#define SIT_MDS_REFINE_ROUNDS    10
+#define SIT_MDS_MIN_NORM         1e-6f
+
+#define N SIT_MDS_MAX_ANCHORS
+
+static float mds_d[N][N];
+static float mds_b[N][N];
+
+static void fill_matrix(const float *distances, uint8_t count, bool measured[N][N]) {
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = 0; j < count; j++) {
+            float dij = distances[i * count + j];
+            float dji = distances[j * count + i];
+            if (i == j) {
+                mds_d[i][j] = 0.0f;
+                measured[i][j] = false;
+            } else if (dij > 0.0f && dji > 0.0f) {
+                mds_d[i][j] = (dij + dji) / 2.0f;
+                measured[i][j] = true;
+            } else if (dij > 0.0f || dji > 0.0f) {
+                mds_d[i][j] = dij > 0.0f ? dij : dji;
+                measured[i][j] = true;
+            } else {
+                mds_d[i][j] = INFINITY;
+                measured[i][j] = false;
+            }
+        }
+    }
+    // shortest path as estimate for pairs without a measurement
+    for (uint8_t k = 0; k < count; k++) {
+        for (uint8_t i = 0; i < count; i++) {
+            for (uint8_t j = 0; j < count; j++) {
+                if (mds_d[i][k] + mds_d[k][j] < mds_d[i][j]) {
+                    mds_d[i][j] = mds_d[i][k] + mds_d[k][j];
+                }
+            }
+        }
+    }
+}
+
+static void double_centering(uint8_t count) {
+    float row_mean[N] = {0};
+    float total_mean = 0.0f;
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = 0; j < count; j++) {
+            float d2 = mds_d[i][j] * mds_d[i][j];
+            row_mean[i] += d2 / count;
+            total_mean += d2 / ((float)count * count);
+        }
+    }
+    // D^2 is symmetric, so the column means equal the row means
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = 0; j < count; j++) {
+            float d2 = mds_d[i][j] * mds_d[i][j];
+            mds_b[i][j] = -0.5f * (d2 - row_mean[i] - row_mean[j] + total_mean);
+        }
+    }
+}
+
+static float power_iteration(uint8_t count, uint8_t component, float *v) {
+    float lambda = 0.0f;
+    for (uint8_t i = 0; i < count; i++) {
+        // deterministic start vector, different for every component
+        v[i] = 1.0f + (float)((i * (component + 3)) % 7);
+    }
+    for (uint16_t iteration = 0; iteration < SIT_MDS_POWER_ITERATIONS; iteration++) {
+        float w[N] = {0};
+        float norm = 0.0f;
+        for (uint8_t i = 0; i < count; i++) {
+            for (uint8_t j = 0; j < count; j++) {
+                w[i] += mds_b[i][j] * v[j];
+            }
+            norm += w[i] * w[i];
+        }
+        norm = sqrtf(norm);
+        if (norm < SIT_MDS_MIN_NORM) {
+            return 0.0f;
+        }
+        lambda = 0.0f;
+        for (uint8_t i = 0; i < count; i++) {
+            lambda += v[i] * w[i];
+            v[i] = w[i] / norm;
+        }
+    }
+    // deflation for the next component
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = 0; j < count; j++) {
+            mds_b[i][j] -= lambda * v[i] * v[j];
+        }
+    }
+    return lambda;
+}
+
+static void refine(uint8_t count, bool solve_3d, bool measured[N][N], sit_vec3_t *positions) {
+    for (uint8_t round = 0; round < SIT_MDS_REFINE_ROUNDS; round++) {
+        for (uint8_t i = 0; i < count; i++) {
+            sit_vec3_t anchors[N];
+            float distances[N];
+            uint8_t neighbours = 0;
+            for (uint8_t j = 0; j < count; j++) {
+                if (measured[i][j]) {
+                    anchors[neighbours] = positions[j];
+                    distances[neighbours] = mds_d[i][j];
+                    neighbours++;
+                }
+            }
+            sit_position_t position = {
+                .x = positions[i].x,
+                .y = positions[i].y,
+                .z = positions[i].z,
+                .valid = true,
+            };
+            if (sit_position_solve(anchors, distances, neighbours, solve_3d, &position)) {
+                positions[i].x = position.x;
+                positions[i].y = position.y;
+                positions[i].z = position.z;
+            }
+        }
+    }
+}
+
+static void local_frame(uint8_t count, bool solve_3d, sit_vec3_t *positions) {
+    sit_vec3_t origin = positions[0];
+    float e1[3] = {
+        positions[1].x - origin.x,
+        positions[1].y - origin.y,
+        positions[1].z - origin.z,
+    };
+    float norm = sqrtf(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+    if (norm < SIT_MDS_MIN_NORM) {
+        return;
+    }
+    for (uint8_t k = 0; k < 3; k++) {
+        e1[k] /= norm;
+    }
+
+    float p2[3] = {
+        positions[2].x - origin.x,
+        positions[2].y - origin.y,
+        positions[2].z - origin.z,
+    };
+    float dot = p2[0] * e1[0] + p2[1] * e1[1] + p2[2] * e1[2];
+    float e2[3];
+    for (uint8_t k = 0; k < 3; k++) {
+        e2[k] = p2[k] - dot * e1[k];
+    }
+    norm = sqrtf(e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2]);
+    if (norm < SIT_MDS_MIN_NORM) {
+        // anchor 0, 1 and 2 on one line, use any perpendicular direction
+        e2[0] = -e1[1];
+        e2[1] = e1[0];
+        e2[2] = 0.0f;
+        norm = sqrtf(e2[0] * e2[0] + e2[1] * e2[1]);
+        if (norm < SIT_MDS_MIN_NORM) {
+            return;
+        }
+    }
+    for (uint8_t k = 0; k < 3; k++) {
+        e2[k] /= norm;
+    }
+    float e3[3] = {
+        e1[1] * e2[2] - e1[2] * e2[1],
+        e1[2] * e2[0] - e1[0] * e2[2],
+        e1[0] * e2[1] - e1[1] * e2[0],
+    };
+
+    for (uint8_t i = 0; i < count; i++) {
+        float p[3] = {
+            positions[i].x - origin.x,
+            positions[i].y - origin.y,
+            positions[i].z - origin.z,
+        };
+        positions[i].x = p[0] * e1[0] + p[1] * e1[1] + p[2] * e1[2];
+        positions[i].y = p[0] * e2[0] + p[1] * e2[1] + p[2] * e2[2];
+        positions[i].z = solve_3d ? p[0] * e3[0] + p[1] * e3[1] + p[2] * e3[2] : 0.0f;
+    }
+    if (solve_3d && count > 3 && positions[3].z < 0.0f) {
+        for (uint8_t i = 0; i < count; i++) {
+            positions[i].z = -positions[i].z;
+        }
+    }
+}
+
+float sit_mds_solve(
+    const float *distances,
+    uint8_t count,
+    bool solve_3d,
+    sit_vec3_t *positions
+) {
+    bool measured[N][N];
+    uint8_t dim = solve_3d ? 3 : 2;
+    if (count < dim + 1 || count > N) {
+        return -1.0f;
+    }
+
+    fill_matrix(distances, count, measured);
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = 0; j < count; j++) {
+            if (isinf(mds_d[i][j])) {
+                // graph of measured pairs is not connected
+                return -1.0f;
+            }
+        }
+    }
+
+    double_centering(count);
+    float v[3][N];
+    float lambda[3];
+    for (uint8_t k = 0; k < dim; k++) {
+        lambda[k] = power_iteration(count, k, v[k]);
+        if (lambda[k] < 0.0f) {
+            lambda[k] = 0.0f;
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        positions[i].x = v[0][i] * sqrtf(lambda[0]);
+        positions[i].y = v[1][i] * sqrtf(lambda[1]);
+        positions[i].z = solve_3d ? v[2][i] * sqrtf(lambda[2]) : 0.0f;
+    }
+
+    refine(count, solve_3d, measured, positions);
+    local_frame(count, solve_3d, positions);
+
+    float sum = 0.0f;
+    uint16_t pairs = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = i + 1; j < count; j++) {
+            if (!measured[i][j]) {
+                continue;
+            }
+            float dx = positions[i].x - positions[j].x;
+            float dy = positions[i].y - positions[j].y;
+            float dz = positions[i].z - positions[j].z;
+            float res = sqrtf(dx * dx + dy * dy + dz * dz) - mds_d[i][j];
+            sum += res * res;
+            pairs++;
+        }
+    }
+    return pairs > 0 ? sqrtf(sum / pairs) : -1.0f;
+}
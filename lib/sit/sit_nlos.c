@@ -0,0 +1,170 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_nlos.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the NLOS feature extractor and classifier.
+ *
+ * The CIR amplitude is approximated with alpha max plus beta min
+ * (15/16 max + 15/32 min, error < 7 %) and normalized to the peak
+ * (4096), so the moments for the kurtosis fit into int64.
+ * The sigmoid is a lookup table for the logit range -8..8 with linear
+ * interpolation.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_nlos.h"
+
+#define NLOS_PEAK           4096
+#define NLOS_RISE_LOW       (NLOS_PEAK / 10)
+#define NLOS_RISE_HIGH      (NLOS_PEAK * 9 / 10)
+#define NLOS_RULE_DB        12 // threshold of the former rule
+
+#define SIGMOID_STEP_SHIFT  6  // 0.25 in Q8
+#define SIGMOID_MIN         (-8 * SIT_NLOS_ONE)
+#define SIGMOID_MAX         (8 * SIT_NLOS_ONE)
+
+static const uint16_t sigmoid_lut[65] = {
+    11, 14, 18, 23, 30, 38, 49, 63,
+    81, 104, 133, 171, 219, 281, 360, 461,
+    589, 753, 961, 1223, 1554, 1969, 2486, 3124,
+    3906, 4851, 5978, 7297, 8813, 10513, 12371, 14347,
+    16384, 18421, 20397, 22255, 23955, 25471, 26790, 27917,
+    28862, 29644, 30282, 30799, 31214, 31545, 31807, 32015,
+    32179, 32307, 32408, 32487, 32549, 32597, 32635, 32664,
+    32687, 32705, 32719, 32730, 32738, 32745, 32750, 32754,
+    32757,
+};
+
+void sit_nlos_model_default(sit_nlos_model_t *model) {
+    for (uint8_t i = 0; i < SIT_NLOS_FEATURES; i++) {
+        model->mean[i] = 0;
+        model->scale[i] = SIT_NLOS_ONE;
+        model->weight[i] = 0;
+    }
+    model->mean[nlos_rsl_fpl] = NLOS_RULE_DB * SIT_NLOS_ONE;
+    model->weight[nlos_rsl_fpl] = SIT_NLOS_ONE;
+    model->bias = 0;
+}
+
+static int32_t to_q8(float value) {
+    return (int32_t)(value * SIT_NLOS_ONE + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+void sit_nlos_model_from_float(
+    sit_nlos_model_t *model,
+    const float *mean,
+    const float *scale,
+    const float *weight,
+    float bias
+) {
+    for (uint8_t i = 0; i < SIT_NLOS_FEATURES; i++) {
+        model->mean[i] = to_q8(mean[i]);
+        model->scale[i] = to_q8(scale[i]);
+        model->weight[i] = to_q8(weight[i]);
+    }
+    model->bias = to_q8(bias);
+}
+
+static int32_t amplitude(const int16_t *iq) {
+    int32_t i = iq[0] < 0 ? -(int32_t)iq[0] : iq[0];
+    int32_t q = iq[1] < 0 ? -(int32_t)iq[1] : iq[1];
+    int32_t max = i > q ? i : q;
+    int32_t min = i > q ? q : i;
+    return (15 * max) / 16 + (15 * min) / 32;
+}
+
+/* Crossing of a threshold between tap index - 1 and index, Q8 */
+static int32_t crossing(uint16_t index, int32_t previous, int32_t current, int32_t threshold) {
+    if (index == 0 || current == previous) {
+        return (int32_t)index << SIT_NLOS_Q;
+    }
+    return ((int32_t)index << SIT_NLOS_Q)
+        - (((current - threshold) << SIT_NLOS_Q) / (current - previous));
+}
+
+void sit_nlos_cir_features(const int16_t *iq, uint16_t taps, int32_t *features) {
+    int32_t peak = 0;
+    features[nlos_rise_time] = 0;
+    features[nlos_kurtosis] = 0;
+    for (uint16_t i = 0; i < taps; i++) {
+        int32_t a = amplitude(&iq[2 * i]);
+        peak = a > peak ? a : peak;
+    }
+    if (peak == 0 || taps < 2) {
+        return;
+    }
+
+    int32_t previous = 0;
+    int32_t rise_low = -1;
+    int32_t rise_high = -1;
+    int64_t sum = 0;
+    for (uint16_t i = 0; i < taps; i++) {
+        int32_t a = amplitude(&iq[2 * i]) * NLOS_PEAK / peak;
+        if (rise_low < 0 && a >= NLOS_RISE_LOW) {
+            rise_low = crossing(i, previous, a, NLOS_RISE_LOW);
+        }
+        if (rise_high < 0 && a >= NLOS_RISE_HIGH) {
+            rise_high = crossing(i, previous, a, NLOS_RISE_HIGH);
+        }
+        previous = a;
+        sum += a;
+    }
+    features[nlos_rise_time] = rise_high - rise_low;
+
+    int32_t mean = (int32_t)(sum / taps);
+    int64_t m2 = 0;
+    int64_t m4 = 0;
+    for (uint16_t i = 0; i < taps; i++) {
+        int64_t d = amplitude(&iq[2 * i]) * NLOS_PEAK / peak - mean;
+        int64_t d2 = d * d;
+        m2 += d2;
+        m4 += d2 * d2;
+    }
+    m2 /= taps;
+    m4 /= taps;
+    if (m2 > 0) {
+        features[nlos_kurtosis] = (int32_t)((m4 << SIT_NLOS_Q) / (m2 * m2));
+    }
+}
+
+uint16_t sit_nlos_probability(const sit_nlos_model_t *model, const int32_t *features) {
+    int64_t logit = (int64_t)model->bias << SIT_NLOS_Q;
+    for (uint8_t i = 0; i < SIT_NLOS_FEATURES; i++) {
+        int64_t z = ((int64_t)(features[i] - model->mean[i]) * model->scale[i]) >> SIT_NLOS_Q;
+        logit += z * model->weight[i];
+    }
+    logit >>= SIT_NLOS_Q;
+
+    if (logit <= SIGMOID_MIN) {
+        return sigmoid_lut[0];
+    }
+    if (logit >= SIGMOID_MAX) {
+        return sigmoid_lut[64];
+    }
+    uint32_t offset = (uint32_t)(logit - SIGMOID_MIN);
+    uint32_t index = offset >> SIGMOID_STEP_SHIFT;
+    uint32_t fraction = offset & ((1 << SIGMOID_STEP_SHIFT) - 1);
+    return sigmoid_lut[index] + (uint16_t)(((sigmoid_lut[index + 1] - sigmoid_lut[index]) * fraction)
+        >> SIGMOID_STEP_SHIFT);
+}
@@ -0,0 +1,398 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_position.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the on-device position engine.
+ *
+ * Multilateration with Gauss-Newton least-squares. Every iteration builds
+ * the normal equations J^T J dx = -J^T r from the unit vectors between the
+ * current estimate and the anchors and solves them with Cramer's rule
+ * (2x2 or 3x3), so no heap and no double precision is needed.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_position.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SIT_POSITION_MIN_RANGE   0.001f // avoid division by zero at an anchor
+#define SIT_POSITION_MIN_STEP    0.001f // convergence threshold in meter
+#define SIT_POSITION_MIN_DET     1e-6f  // singular geometry threshold
+#define SIT_POSITION_MIN_PRIOR   0.05f  // every anchor keeps a chance to be sampled
+#define SIT_POSITION_RSL_FSL_LOS 6.0f   // RSL - FSL in dB of a clear LOS channel
+#define SIT_POSITION_RSL_FSL_SPAN 10.0f // RSL - FSL range from LOS to NLOS
+
+#ifdef CONFIG_SIT_POSITION_3D
+    #define SIT_POSITION_SOLVE_3D true
+#else
+    #define SIT_POSITION_SOLVE_3D false
+#endif
+
+static sit_vec3_t anchor_position[SIT_POSITION_MAX_ANCHORS];
+static bool anchor_valid[SIT_POSITION_MAX_ANCHORS];
+static float anchor_distance[SIT_POSITION_MAX_ANCHORS];
+static uint32_t anchor_sequence[SIT_POSITION_MAX_ANCHORS];
+static bool anchor_measured[SIT_POSITION_MAX_ANCHORS];
+static float anchor_prior[SIT_POSITION_MAX_ANCHORS];
+
+static uint32_t ransac_state = 0x2545F491;
+
+static sit_position_t last_position;
+
+static bool solve_normal_equations(float a[3][3], const float b[3], uint8_t dim, float x[3]) {
+    if (dim == 2) {
+        float det = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        if (fabsf(det) < SIT_POSITION_MIN_DET) {
+            return false;
+        }
+        x[0] = (b[0] * a[1][1] - a[0][1] * b[1]) / det;
+        x[1] = (a[0][0] * b[1] - b[0] * a[1][0]) / det;
+        x[2] = 0.0f;
+        return true;
+    }
+
+    float c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+    float c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+    float c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+    float det = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+    if (fabsf(det) < SIT_POSITION_MIN_DET) {
+        return false;
+    }
+    float c10 = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+    float c11 = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+    float c12 = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+    float c20 = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+    float c21 = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+    float c22 = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+
+    x[0] = (c00 * b[0] + c10 * b[1] + c20 * b[2]) / det;
+    x[1] = (c01 * b[0] + c11 * b[1] + c21 * b[2]) / det;
+    x[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) / det;
+    return true;
+}
+
+bool sit_position_solve(
+    const sit_vec3_t *anchors,
+    const float *distances,
+    uint8_t count,
+    bool solve_3d,
+    sit_position_t *position
+) {
+    uint8_t dim = solve_3d ? 3 : 2;
+    if (count < dim + 1) {
+        position->valid = false;
+        return false;
+    }
+
+    float p[3];
+    if (position->valid) {
+        p[0] = position->x;
+        p[1] = position->y;
+        p[2] = position->z;
+    } else {
+        // start in the centroid of the anchors
+        p[0] = 0.0f;
+        p[1] = 0.0f;
+        p[2] = 0.0f;
+        for (uint8_t i = 0; i < count; i++) {
+            p[0] += anchors[i].x;
+            p[1] += anchors[i].y;
+            p[2] += anchors[i].z;
+        }
+        p[0] /= count;
+        p[1] /= count;
+        p[2] = solve_3d ? p[2] / count : position->z;
+    }
+
+    float sum_res = 0.0f;
+    uint8_t iteration = 0;
+    bool converged = false;
+    while (iteration < CONFIG_SIT_POSITION_MAX_ITERATIONS && !converged) {
+        float jtj[3][3] = {{0}};
+        float jtr[3] = {0};
+        sum_res = 0.0f;
+        for (uint8_t i = 0; i < count; i++) {
+            float u[3] = {
+                p[0] - anchors[i].x,
+                p[1] - anchors[i].y,
+                p[2] - anchors[i].z,
+            };
+            float range = sqrtf(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+            if (range < SIT_POSITION_MIN_RANGE) {
+                range = SIT_POSITION_MIN_RANGE;
+            }
+            float res = range - distances[i];
+            sum_res += res * res;
+            for (uint8_t r = 0; r < dim; r++) {
+                u[r] /= range;
+            }
+            // J^T J is symmetric, accumulate the lower triangle only
+            for (uint8_t r = 0; r < dim; r++) {
+                jtr[r] -= u[r] * res;
+                for (uint8_t c = 0; c <= r; c++) {
+                    jtj[r][c] += u[r] * u[c];
+                }
+            }
+        }
+        for (uint8_t r = 0; r < dim; r++) {
+            for (uint8_t c = 0; c < r; c++) {
+                jtj[c][r] = jtj[r][c];
+            }
+        }
+
+        float dx[3];
+        if (!solve_normal_equations(jtj, jtr, dim, dx)) {
+            position->valid = false;
+            return false;
+        }
+        float step = 0.0f;
+        for (uint8_t r = 0; r < dim; r++) {
+            p[r] += dx[r];
+            step += dx[r] * dx[r];
+        }
+        iteration++;
+        converged = step < (SIT_POSITION_MIN_STEP * SIT_POSITION_MIN_STEP);
+    }
+
+    position->x = p[0];
+    position->y = p[1];
+    position->z = p[2];
+    position->quality = sqrtf(sum_res / count);
+    position->anchors = count;
+    position->iterations = iteration;
+    position->hypotheses = 0;
+    position->valid = isfinite(p[0]) && isfinite(p[1]) && isfinite(p[2]);
+    return position->valid;
+}
+
+static uint32_t ransac_random(void) {
+    // xorshift32, deterministic and cheap
+    ransac_state ^= ransac_state << 13;
+    ransac_state ^= ransac_state >> 17;
+    ransac_state ^= ransac_state << 5;
+    return ransac_state;
+}
+
+/**
+ * Draw a subset of size m without replacement, weighted with the prior.
+ */
+static void ransac_sample(const float *prior, uint8_t count, uint8_t m, uint8_t *subset) {
+    bool used[SIT_POSITION_MAX_ANCHORS] = {false};
+    for (uint8_t s = 0; s < m; s++) {
+        float total = 0.0f;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!used[i]) {
+                total += prior ? prior[i] : 1.0f;
+            }
+        }
+        float pick = total * ((float)(ransac_random() >> 8) / (float)(1UL << 24));
+        uint8_t chosen = count;
+        for (uint8_t i = 0; i < count; i++) {
+            if (used[i]) {
+                continue;
+            }
+            chosen = i;
+            pick -= prior ? prior[i] : 1.0f;
+            if (pick < 0.0f) {
+                break;
+            }
+        }
+        used[chosen] = true;
+        subset[s] = chosen;
+    }
+}
+
+bool sit_position_solve_robust(
+    const sit_vec3_t *anchors,
+    const float *distances,
+    const float *prior,
+    uint8_t count,
+    bool solve_3d,
+    sit_position_t *position
+) {
+    uint8_t m = solve_3d ? 4 : 3;
+    if (count <= m) {
+        // no redundancy (needs m + 1 anchors), nothing to reject
+        return sit_position_solve(anchors, distances, count, solve_3d, position);
+    }
+
+    const float threshold = CONFIG_SIT_POSITION_RANSAC_THRESHOLD_CM / 100.0f;
+    bool best_inlier[SIT_POSITION_MAX_ANCHORS] = {false};
+    uint8_t best_count = 0;
+    float best_error = 0.0f;
+    uint8_t hypotheses = 0;
+
+    for (uint8_t iteration = 0; iteration < CONFIG_SIT_POSITION_RANSAC_ITERATIONS; iteration++) {
+        hypotheses++;
+        uint8_t subset[4];
+        sit_vec3_t subset_anchors[4];
+        float subset_distances[4];
+        ransac_sample(prior, count, m, subset);
+        for (uint8_t i = 0; i < m; i++) {
+            subset_anchors[i] = anchors[subset[i]];
+            subset_distances[i] = distances[subset[i]];
+        }
+
+        sit_position_t hypothesis = *position;
+        if (!sit_position_solve(subset_anchors, subset_distances, m, solve_3d, &hypothesis)) {
+            continue;
+        }
+
+        bool inlier[SIT_POSITION_MAX_ANCHORS];
+        uint8_t inliers = 0;
+        float error = 0.0f;
+        for (uint8_t i = 0; i < count; i++) {
+            float dx = hypothesis.x - anchors[i].x;
+            float dy = hypothesis.y - anchors[i].y;
+            float dz = hypothesis.z - anchors[i].z;
+            float res = fabsf(sqrtf(dx * dx + dy * dy + dz * dz) - distances[i]);
+            inlier[i] = res < threshold;
+            if (inlier[i]) {
+                inliers++;
+                error += res;
+            }
+        }
+        if (inliers > best_count || (inliers == best_count && error < best_error)) {
+            best_count = inliers;
+            best_error = error;
+            memcpy(best_inlier, inlier, sizeof(best_inlier));
+        }
+        if (best_count == count) {
+            break;
+        }
+    }
+
+    bool valid;
+    if (best_count < m) {
+        valid = sit_position_solve(anchors, distances, count, solve_3d, position);
+        position->hypotheses = hypotheses;
+        return valid;
+    }
+
+    sit_vec3_t consensus_anchors[SIT_POSITION_MAX_ANCHORS];
+    float consensus_distances[SIT_POSITION_MAX_ANCHORS];
+    uint8_t consensus = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (best_inlier[i]) {
+            consensus_anchors[consensus] = anchors[i];
+            consensus_distances[consensus] = distances[i];
+            consensus++;
+        }
+    }
+    valid = sit_position_solve(consensus_anchors, consensus_distances, consensus, solve_3d, position);
+    position->hypotheses = hypotheses;
+    return valid;
+}
+
+float sit_position_prior(uint8_t nlos, float rssi, float fpi) {
+    // the more power arrives after the first path the less we trust the range
+    float prior = 1.0f - ((rssi - fpi) - SIT_POSITION_RSL_FSL_LOS) / SIT_POSITION_RSL_FSL_SPAN;
+    if (prior > 1.0f) {
+        prior = 1.0f;
+    }
+    prior *= 1.0f - 0.5f * ((float)nlos / 100.0f);
+    if (!(prior >= SIT_POSITION_MIN_PRIOR)) {
+        prior = SIT_POSITION_MIN_PRIOR;
+    }
+    return prior;
+}
+
+void sit_position_set_anchor(uint8_t index, float x, float y, float z) {
+    if (index >= SIT_POSITION_MAX_ANCHORS) {
+        return;
+    }
+    anchor_position[index].x = x;
+    anchor_position[index].y = y;
+    anchor_position[index].z = z;
+    anchor_valid[index] = true;
+    last_position.valid = false;
+}
+
+void sit_position_clear(void) {
+    memset(anchor_valid, 0, sizeof(anchor_valid));
+    memset(anchor_measured, 0, sizeof(anchor_measured));
+    last_position.valid = false;
+}
+
+void sit_position_set_distance(uint8_t index, float distance, uint32_t sequence) {
+    if (index >= SIT_POSITION_MAX_ANCHORS) {
+        return;
+    }
+    anchor_distance[index] = distance;
+    anchor_sequence[index] = sequence;
+    anchor_measured[index] = true;
+    anchor_prior[index] = 1.0f;
+}
+
+void sit_position_set_prior(uint8_t index, float prior) {
+    if (index >= SIT_POSITION_MAX_ANCHORS) {
+        return;
+    }
+    anchor_prior[index] = prior;
+}
+
+bool sit_position_fix(uint32_t sequence, sit_position_t *position) {
+    sit_vec3_t anchors[SIT_POSITION_MAX_ANCHORS];
+    float distances[SIT_POSITION_MAX_ANCHORS];
+    float prior[SIT_POSITION_MAX_ANCHORS];
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < SIT_POSITION_MAX_ANCHORS; i++) {
+        if (anchor_valid[i] && anchor_measured[i] &&
+            (sequence - anchor_sequence[i]) <= CONFIG_SIT_POSITION_MAX_AGE) {
+            anchors[count] = anchor_position[i];
+            distances[count] = anchor_distance[i];
+            prior[count] = anchor_prior[i];
+            count++;
+        }
+    }
+
+    sit_position_t fix = last_position;
+#ifdef CONFIG_SIT_POSITION_RANSAC
+    bool valid = sit_position_solve_robust(anchors, distances, prior, count, SIT_POSITION_SOLVE_3D, &fix);
+#else
+    (void)prior;
+    bool valid = sit_position_solve(anchors, distances, count, SIT_POSITION_SOLVE_3D, &fix);
+#endif
+    if (valid) {
+        last_position = fix;
+    } else {
+        last_position.valid = false;
+    }
+    *position = fix;
+    return fix.valid;
+}
+
+bool sit_position_get_anchor(uint8_t index, sit_vec3_t *anchor) {
+    if (index >= SIT_POSITION_MAX_ANCHORS || !anchor_valid[index]) {
+        return false;
+    }
+    *anchor = anchor_position[index];
+    return true;
+}
+
+bool sit_position_last(sit_position_t *position) {
+    *position = last_position;
+    return last_position.valid;
+}
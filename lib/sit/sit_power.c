@@ -0,0 +1,148 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_power.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the DW3000 deep sleep duty cycle and energy model.
+ *
+ * Energy model: the awake time without the tx air time is counted as rx,
+ * the initiator listens for the responses most of the awake time. So the
+ * result is an upper bound of the average current.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_power.h"
+#include "sit/sit.h"
+#include "sit/sit_config.h"
+#include "sit/sit_device.h"
+#ifdef CONFIG_SIT_TEMP_COMP
+	#include "sit/sit_temp.h"
+#endif
+
+#include <deca_device_api.h>
+#include <dw3000_hw.h>
+#include <port.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_POWER, LOG_LEVEL_INF);
+
+/* Wait for IDLE_RC after the wake up, in 10 us steps */
+#define SIT_POWER_IDLE_RC_RETRIES 200
+#define SIT_POWER_REPORT_CYCLES 100
+
+static sit_power_stats_t power_stats;
+static int64_t awake_since;
+
+void sit_power_init(void) {
+	/* download the AON array on wake up, wake up on WAKEUP pin or chip select, deep sleep */
+	dwt_configuresleep(DWT_CONFIG, DWT_PRES_SLEEP | DWT_WAKE_WUP | DWT_WAKE_CSN | DWT_SLP_EN);
+	awake_since = k_uptime_get();
+}
+
+void sit_power_count_tx(void) {
+	power_stats.tx_frames++;
+}
+
+static bool wakeup(void) {
+	port_set_dw_ic_spi_slowrate();
+	dw3000_hw_wakeup();
+	uint16_t retry = 0;
+	while (!dwt_checkidlerc()) {
+		if (++retry > SIT_POWER_IDLE_RC_RETRIES) {
+			dw3000_hw_wakeup_pin_low();
+			LOG_ERR("DW3000 wake up failed");
+			return false;
+		}
+		k_busy_wait(10);
+	}
+	dw3000_hw_wakeup_pin_low();
+	port_set_dw_ic_spi_fastrate();
+
+	/* configuration which is not restored from AON */
+	dwt_restoreconfig();
+	set_antenna_delay(device_settings.rx_ant_dly, device_settings.tx_ant_dly);
+	if (device_settings.xtal_trim) {
+		dwt_setxtaltrim(device_settings.xtal_trim);
+	}
+	dwt_setlnapamode(DWT_LNA_ENABLE | DWT_PA_ENABLE);
+	dwt_configciadiag(DW_CIA_DIAG_LOG_ALL);
+	#ifdef CONFIG_SIT_TEMP_COMP
+		sit_temp_apply();
+	#endif
+	return true;
+}
+
+static void update_model(void) {
+	uint64_t tx_us = (uint64_t)power_stats.tx_frames * SIT_POWER_FRAME_US;
+	uint64_t rx_us = power_stats.awake_us > tx_us ? power_stats.awake_us - tx_us : 0;
+	uint64_t total_us = power_stats.sleep_us + power_stats.awake_us;
+	if (total_us == 0) {
+		return;
+	}
+	double charge = (double)power_stats.sleep_us * CONFIG_SIT_POWER_SLEEP_UA
+		+ (double)tx_us * CONFIG_SIT_POWER_TX_UA
+		+ (double)rx_us * CONFIG_SIT_POWER_RX_UA;
+	power_stats.average_ua = (float)(charge / total_us);
+}
+
+void sit_power_duty_cycle(int64_t cycle_start, uint32_t period_ms) {
+	int64_t now = k_uptime_get();
+	int64_t wakeup_ms = cycle_start + period_ms - DIV_ROUND_UP(CONFIG_SIT_POWER_WAKEUP_US, 1000);
+	if (now >= wakeup_ms) {
+		// no time left to sleep, the cycle took too long
+		k_msleep(MAX(cycle_start + period_ms - now, 0));
+		return;
+	}
+	power_stats.awake_us += (now - awake_since) * 1000;
+
+	dwt_entersleep(DWT_DW_IDLE);
+	k_sleep(K_TIMEOUT_ABS_MS(wakeup_ms));
+	if (!wakeup() && !wakeup()) {
+		// the configuration is lost, reset and configure the DW3000 again
+		LOG_WRN("DW3000 still sleeping, re-initialize");
+		if (sit_reconfigure() > 1) {
+			LOG_ERR("DW3000 re-initialization failed");
+		}
+	}
+	awake_since = k_uptime_get();
+	power_stats.sleep_us += (awake_since - now) * 1000;
+	power_stats.cycles++;
+
+	int64_t start = cycle_start + period_ms;
+	if (awake_since < start) {
+		k_sleep(K_TIMEOUT_ABS_MS(start));
+	}
+
+	if (power_stats.cycles % SIT_POWER_REPORT_CYCLES == 0) {
+		update_model();
+		LOG_INF("DW3000 average current: %u uA (sleep %u%%, %u tx frames)", 
+			(uint32_t)power_stats.average_ua,
+			(uint32_t)(power_stats.sleep_us * 100 / (power_stats.sleep_us + power_stats.awake_us)),
+			power_stats.tx_frames);
+	}
+}
+
+void sit_power_get_stats(sit_power_stats_t *stats) {
+	update_model();
+	*stats = power_stats;
+}
@@ -0,0 +1,60 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_range_bias.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the range bias correction.
+ *
+ * Linear interpolation between the table entries in integer math,
+ * scripts/gen_range_bias.py uses the same arithmetic for the evaluation.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_range_bias.h"
+
+#include "sit_range_bias_tables.h"
+
+static const int16_t *select_table(uint8_t channel, bool prf_64) {
+    if (channel == 9) {
+        return prf_64 ? sit_range_bias_ch9_prf64 : sit_range_bias_ch9_prf16;
+    }
+    return prf_64 ? sit_range_bias_ch5_prf64 : sit_range_bias_ch5_prf16;
+}
+
+int32_t sit_range_bias_mm(uint8_t channel, bool prf_64, int32_t rsl_q8) {
+    const int16_t *table = select_table(channel, prf_64);
+    if (rsl_q8 <= SIT_RANGE_BIAS_RSL_MIN_Q8) {
+        return table[0];
+    }
+    int32_t offset = rsl_q8 - SIT_RANGE_BIAS_RSL_MIN_Q8;
+    int32_t index = offset / SIT_RANGE_BIAS_STEP_Q8;
+    if (index >= SIT_RANGE_BIAS_LEN - 1) {
+        return table[SIT_RANGE_BIAS_LEN - 1];
+    }
+    int32_t fraction = offset % SIT_RANGE_BIAS_STEP_Q8;
+    return table[index] + (table[index + 1] - table[index]) * fraction / SIT_RANGE_BIAS_STEP_Q8;
+}
+
+int32_t sit_range_bias_correct_mm(int32_t distance_mm, uint8_t channel, bool prf_64, int32_t rsl_q8) {
+    return distance_mm - sit_range_bias_mm(channel, prf_64, rsl_q8);
+}
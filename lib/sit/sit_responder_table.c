@@ -0,0 +1,108 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_responder_table.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the responder table of the anchor discovery.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_responder_table.h"
+
+void sit_responder_table_reset(sit_responder_table_t *table) {
+    table->count = 0;
+}
+
+int16_t sit_responder_table_find(const sit_responder_table_t *table, uint16_t address) {
+    for (uint16_t i = 0; i < table->count; i++) {
+        if (table->address[i] == address) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int16_t sit_responder_table_seen(sit_responder_table_t *table, uint16_t address, uint32_t now_ms) {
+    int16_t index = sit_responder_table_find(table, address);
+    if (index < 0) {
+        if (table->count >= SIT_RESPONDER_TABLE_SIZE) {
+            return -1;
+        }
+        index = table->count++;
+        table->address[index] = address;
+        table->link_quality[index] = SIT_RESPONDER_QUALITY_START;
+        table->distance_mm[index] = INT32_MIN;
+        table->clock_offset[index] = 0;
+    }
+    table->last_seen[index] = now_ms;
+    return index;
+}
+
+void sit_responder_table_update(
+    sit_responder_table_t *table,
+    uint16_t index,
+    bool success,
+    int32_t distance_mm,
+    int16_t clock_offset,
+    uint32_t now_ms
+) {
+    if (index >= table->count) {
+        return;
+    }
+    int16_t quality = table->link_quality[index];
+    quality += ((success ? 255 : 0) - quality) / (1 << SIT_RESPONDER_QUALITY_SHIFT);
+    table->link_quality[index] = (uint8_t)quality;
+    if (!success) {
+        return;
+    }
+    table->last_seen[index] = now_ms;
+    table->clock_offset[index] = clock_offset;
+    if (distance_mm == INT32_MIN) {
+        return;
+    }
+    if (table->distance_mm[index] == INT32_MIN) {
+        table->distance_mm[index] = distance_mm;
+    } else {
+        table->distance_mm[index] += (distance_mm - table->distance_mm[index]) / (1 << SIT_RESPONDER_DISTANCE_SHIFT);
+    }
+}
+
+uint16_t sit_responder_table_age(sit_responder_table_t *table, uint32_t now_ms, uint32_t timeout_ms) {
+    uint16_t removed = 0;
+    uint16_t i = 0;
+    while (i < table->count) {
+        // unsigned difference, the uptime in ms wraps after 49 days
+        if (now_ms - table->last_seen[i] <= timeout_ms) {
+            i++;
+            continue;
+        }
+        uint16_t last = --table->count;
+        table->address[i] = table->address[last];
+        table->last_seen[i] = table->last_seen[last];
+        table->link_quality[i] = table->link_quality[last];
+        table->distance_mm[i] = table->distance_mm[last];
+        table->clock_offset[i] = table->clock_offset[last];
+        removed++;
+    }
+    return removed;
+}
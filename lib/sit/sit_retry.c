@@ -0,0 +1,72 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_retry.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the in-cycle retry policy of the initiator.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_retry.h"
+
+void sit_retry_reset(sit_retry_stats_t *stats) {
+    stats->count = 0;
+}
+
+bool sit_retry_allowed(uint8_t attempts, uint32_t exchange_us, uint32_t remaining_us, uint16_t responders_left) {
+    if (attempts > CONFIG_SIT_RETRY_MAX) {
+        return false;
+    }
+    uint64_t needed_us = (uint64_t)exchange_us * (1 + responders_left);
+    return needed_us <= remaining_us;
+}
+
+int16_t sit_retry_record(sit_retry_stats_t *stats, uint16_t address, uint8_t attempts, bool success) {
+    int16_t index = -1;
+    for (uint16_t i = 0; i < stats->count; i++) {
+        if (stats->address[i] == address) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        if (stats->count >= SIT_RETRY_MAX_RESPONDERS) {
+            return -1;
+        }
+        index = stats->count++;
+        stats->address[index] = address;
+        stats->cycles[index] = 0;
+        stats->ranges[index] = 0;
+        stats->retries[index] = 0;
+        stats->recovered[index] = 0;
+    }
+    stats->cycles[index]++;
+    stats->retries[index] += attempts > 1 ? attempts - 1 : 0;
+    if (success) {
+        stats->ranges[index]++;
+        if (attempts > 1) {
+            stats->recovered[index]++;
+        }
+    }
+    return index;
+}
@@ -0,0 +1,86 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_rx_window.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the scheduled RX windows of a responder.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_rx_window.h"
+
+#include <math.h>
+
+/* 1 us in DWT time units (499.2 MHz * 128) */
+#define DTU_PER_US 63897.6
+
+/* Smoothing as for the TCP round trip time (RFC 6298) */
+#define INTERVAL_GAIN  0.125
+#define DEVIATION_GAIN 0.25
+#define GUARD_FACTOR   4.0
+
+void sit_rx_window_reset(sit_rx_window_t *window, double interval) {
+    window->last_rx = 0;
+    window->interval = interval;
+    // wide start window, shrinks with the first polls
+    window->deviation = interval / 16.0;
+    window->misses = 0;
+    window->locked = false;
+}
+
+void sit_rx_window_update(sit_rx_window_t *window, uint64_t rx_ts) {
+    if (window->locked) {
+        double measured = (double)((rx_ts - window->last_rx) & SIT_RX_WINDOW_TIMESTAMP_MASK);
+        // polls can be missed, compare with the closest number of intervals
+        double periods = fmax(round(measured / window->interval), 1.0);
+        double error = measured / periods - window->interval;
+        window->deviation += DEVIATION_GAIN * (fabs(error) - window->deviation);
+        window->interval += INTERVAL_GAIN * error;
+    }
+    window->last_rx = rx_ts & SIT_RX_WINDOW_TIMESTAMP_MASK;
+    window->misses = 0;
+    window->locked = true;
+}
+
+void sit_rx_window_miss(sit_rx_window_t *window) {
+    window->misses++;
+    if (window->misses >= CONFIG_SIT_RX_WINDOW_MAX_MISSES) {
+        window->locked = false;
+        window->misses = 0;
+    }
+}
+
+double sit_rx_window_guard(const sit_rx_window_t *window) {
+    double guard = GUARD_FACTOR * window->deviation * (1 + window->misses);
+    return fmin(fmax(guard, CONFIG_SIT_RX_WINDOW_MIN_GUARD_US * DTU_PER_US), window->interval / 4.0);
+}
+
+bool sit_rx_window_next(const sit_rx_window_t *window, uint64_t *start, double *length) {
+    if (!window->locked) {
+        return false;
+    }
+    double guard = sit_rx_window_guard(window);
+    double expected = window->interval * (1 + window->misses);
+    *start = (window->last_rx + (uint64_t)(expected - guard)) & SIT_RX_WINDOW_TIMESTAMP_MASK;
+    *length = 2.0 * guard;
+    return true;
+}
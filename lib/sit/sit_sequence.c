@@ -0,0 +1,84 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_sequence.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the sequence number extension.
+ *
+ * A gap counts the skipped sequences as lost, a late frame inside the
+ * window takes one back, so lost is always the number of sequences which
+ * are missing at the moment.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_sequence.h"
+
+uint32_t sit_sequence_extend(uint32_t reference, uint16_t sequence) {
+    int16_t delta = (int16_t)(sequence - (uint16_t)reference);
+    return reference + (uint32_t)(int32_t)delta;
+}
+
+void sit_sequence_reset(sit_sequence_t *tracker) {
+    *tracker = (sit_sequence_t){0};
+}
+
+sit_sequence_status_t sit_sequence_update(sit_sequence_t *tracker, uint16_t sequence, uint32_t *extended) {
+    if (!tracker->started) {
+        tracker->started = true;
+        tracker->highest = sequence;
+        tracker->window = 1;
+        tracker->received++;
+        *extended = sequence;
+        return sit_sequence_next;
+    }
+    *extended = sit_sequence_extend(tracker->highest, sequence);
+    int32_t diff = (int32_t)(*extended - tracker->highest);
+    if (diff > 0) {
+        tracker->window = diff < SIT_SEQUENCE_WINDOW ? (tracker->window << diff) | 1 : 1;
+        tracker->lost += (uint32_t)diff - 1;
+        tracker->highest = *extended;
+        tracker->received++;
+        return sit_sequence_next;
+    }
+    uint32_t age = (uint32_t)-diff;
+    if (age >= SIT_SEQUENCE_WINDOW) {
+        // far behind the window: the sender restarted, a new session starts,
+        // the statistic of the old session is kept
+        tracker->started = false;
+        tracker->highest = 0;
+        tracker->window = 0;
+        sit_sequence_update(tracker, sequence, extended);
+        return sit_sequence_restart;
+    }
+    if (tracker->window & (1UL << age)) {
+        tracker->duplicates++;
+        return sit_sequence_duplicate;
+    }
+    tracker->window |= 1UL << age;
+    tracker->received++;
+    tracker->reordered++;
+    if (tracker->lost > 0) {
+        tracker->lost--;
+    }
+    return sit_sequence_late;
+}
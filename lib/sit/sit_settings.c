@@ -0,0 +1,170 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_settings.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the persistent settings store.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_settings.h"
+#include "sit/sit_config.h"
+#include "sit/sit_position.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_SETTINGS, LOG_LEVEL_INF);
+
+#define SIT_SETTINGS_KEY "sit/device"
+#define SIT_SETTINGS_MAX_ANCHORS SIT_POSITION_MAX_ANCHORS
+
+typedef struct {
+	uint8_t version;
+	uint16_t device_id;
+	uint8_t device_type;
+	uint16_t responder;
+	uint8_t measurement_type;
+	uint8_t anchors;
+	uint8_t xtal_trim;
+	uint16_t tx_ant_dly;
+	uint16_t rx_ant_dly;
+	float ant_dly_temp_coeff;
+	float anchor_position[SIT_SETTINGS_MAX_ANCHORS][3];
+} sit_settings_record_t;
+
+static bool restored = false;
+// role of the last setup, a stop or disconnect (none) does not clear it
+static device_type_t persisted_type = none;
+
+static void save_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(save_work, save_work_handler);
+
+static void save_work_handler(struct k_work *work) {
+	if (device_type != none) {
+		persisted_type = device_type;
+	}
+	sit_settings_record_t record = {
+		.version = SIT_SETTINGS_VERSION,
+		.device_id = device_settings.deviceID,
+		.device_type = (uint8_t)persisted_type,
+		.responder = device_settings.responder,
+		.measurement_type = (uint8_t)device_settings.measurement_type,
+		.anchors = 0,
+		.xtal_trim = device_settings.xtal_trim,
+		.tx_ant_dly = device_settings.tx_ant_dly,
+		.rx_ant_dly = device_settings.rx_ant_dly,
+		.ant_dly_temp_coeff = device_settings.ant_dly_temp_coeff,
+	};
+	#ifdef CONFIG_SIT_POSITION
+		sit_vec3_t anchor;
+		while (record.anchors < SIT_SETTINGS_MAX_ANCHORS 
+				&& sit_position_get_anchor(record.anchors, &anchor)) {
+			record.anchor_position[record.anchors][0] = anchor.x;
+			record.anchor_position[record.anchors][1] = anchor.y;
+			record.anchor_position[record.anchors][2] = anchor.z;
+			record.anchors++;
+		}
+	#endif
+	int err = settings_save_one(SIT_SETTINGS_KEY, &record, sizeof(record));
+	if (err) {
+		LOG_ERR("Settings save failed (err %d)", err);
+	} else {
+		LOG_INF("Settings saved");
+	}
+}
+
+static void apply_record(const sit_settings_record_t *record) {
+	device_settings.deviceID = record->device_id;
+	device_settings.responder = record->responder;
+	device_settings.measurement_type = (measurement_type_t)record->measurement_type;
+	device_settings.tx_ant_dly = record->tx_ant_dly;
+	device_settings.rx_ant_dly = record->rx_ant_dly;
+	device_settings.ant_dly_temp_coeff = record->ant_dly_temp_coeff;
+	device_settings.xtal_trim = record->xtal_trim;
+	device_type = (device_type_t)record->device_type;
+	persisted_type = device_type;
+	#ifdef CONFIG_SIT_POSITION
+		sit_position_clear();
+		for (uint8_t i = 0; i < MIN(record->anchors, SIT_SETTINGS_MAX_ANCHORS); i++) {
+			sit_position_set_anchor(i, 
+				record->anchor_position[i][0], 
+				record->anchor_position[i][1], 
+				record->anchor_position[i][2]);
+		}
+	#endif
+}
+
+static int settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+	const char *next;
+	if (!settings_name_steq(name, "device", &next) || next) {
+		return -ENOENT;
+	}
+	sit_settings_record_t record;
+	if (len != sizeof(record)) {
+		LOG_WRN("Settings record size %zu, expected %zu, ignored", len, sizeof(record));
+		return 0;
+	}
+	int ret = read_cb(cb_arg, &record, sizeof(record));
+	if (ret < 0) {
+		return ret;
+	}
+	if (record.version != SIT_SETTINGS_VERSION) {
+		LOG_WRN("Settings record version %d, expected %d, ignored", record.version, SIT_SETTINGS_VERSION);
+		return 0;
+	}
+	apply_record(&record);
+	restored = true;
+	LOG_INF("Settings restored: Device ID %d, RX %d, TX %d", 
+		record.device_id, record.rx_ant_dly, record.tx_ant_dly);
+	return 0;
+}
+
+static struct settings_handler sit_settings_handler = {
+	.name = "sit",
+	.h_set = settings_set,
+};
+
+int sit_settings_init(void) {
+	int err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("Settings init failed (err %d)", err);
+		return err;
+	}
+	err = settings_register(&sit_settings_handler);
+	if (err) {
+		LOG_ERR("Settings register failed (err %d)", err);
+		return err;
+	}
+	return settings_load_subtree("sit");
+}
+
+void sit_settings_save(void) {
+	k_work_reschedule(&save_work, K_MSEC(CONFIG_SIT_SETTINGS_SAVE_DELAY_MS));
+}
+
+bool sit_settings_autostart(void) {
+	return restored && device_type == responder;
+}
@@ -0,0 +1,110 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_slot_table.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the slot table of the superframe coordinator.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_slot_table.h"
+
+void sit_slot_table_init(sit_slot_table_t *table, uint8_t slots) {
+    table->slots = slots > SIT_SLOT_TABLE_SIZE ? SIT_SLOT_TABLE_SIZE : slots;
+    for (uint8_t i = 0; i < SIT_SLOT_TABLE_SIZE; i++) {
+        table->owner[i] = SIT_SLOT_FREE;
+        table->idle[i] = 0;
+    }
+}
+
+int16_t sit_slot_table_find(const sit_slot_table_t *table, uint16_t tag) {
+    for (uint8_t i = 0; i < table->slots; i++) {
+        if (table->owner[i] == tag) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int16_t sit_slot_table_grant(sit_slot_table_t *table, uint16_t tag) {
+    int16_t slot = sit_slot_table_find(table, tag);
+    if (slot < 0) {
+        slot = sit_slot_table_find(table, SIT_SLOT_FREE);
+        if (slot < 0) {
+            return -1;
+        }
+        table->owner[slot] = tag;
+    }
+    table->idle[slot] = 0;
+    return slot;
+}
+
+bool sit_slot_table_release(sit_slot_table_t *table, uint16_t tag) {
+    int16_t slot = sit_slot_table_find(table, tag);
+    if (slot < 0) {
+        return false;
+    }
+    table->owner[slot] = SIT_SLOT_FREE;
+    table->idle[slot] = 0;
+    return true;
+}
+
+void sit_slot_table_seen(sit_slot_table_t *table, uint16_t tag) {
+    int16_t slot = sit_slot_table_find(table, tag);
+    if (slot >= 0) {
+        table->idle[slot] = 0;
+    }
+}
+
+uint8_t sit_slot_table_age(sit_slot_table_t *table, uint16_t max_idle) {
+    uint8_t revoked = 0;
+    for (uint8_t i = 0; i < table->slots; i++) {
+        if (table->owner[i] == SIT_SLOT_FREE) {
+            continue;
+        }
+        if (++table->idle[i] > max_idle) {
+            table->owner[i] = SIT_SLOT_FREE;
+            table->idle[i] = 0;
+            revoked++;
+        }
+    }
+    return revoked;
+}
+
+uint8_t sit_slot_table_used(const sit_slot_table_t *table) {
+    uint8_t used = 0;
+    for (uint8_t i = 0; i < table->slots; i++) {
+        if (table->owner[i] != SIT_SLOT_FREE) {
+            used++;
+        }
+    }
+    return used;
+}
+
+int16_t sit_slot_table_slot_at(const sit_slot_table_t *table, uint32_t offset_ms, uint16_t slot_ms) {
+    uint32_t slot = offset_ms / slot_ms;
+    if (slot == 0 || slot > table->slots) {
+        return -1;
+    }
+    return (int16_t)(slot - 1);
+}
@@ -0,0 +1,283 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_slots.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the multi-tag superframe.
+ *
+ * The tags synchronise to the reception of the beacon with the uptime in
+ * ms, so a slot has a guard of a few ms at both ends. A missed beacon is
+ * predicted from the last one, after MAX_MISSED_BEACONS the tag gives up
+ * its slot and listens until the next beacon.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_slots.h"
+#include "sit/sit_distance.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/random/random.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_SLOTS, LOG_LEVEL_INF);
+
+#define SUPERFRAME_MS ((CONFIG_SIT_SLOTS_COUNT + 1) * CONFIG_SIT_SLOTS_SLOT_MS)
+#define REPORT_SUPERFRAMES 100
+#define MAX_MISSED_BEACONS 3
+/* the receiver of the tag is on this time before the expected beacon */
+#define BEACON_GUARD_MS 2
+/* a slot request ends this time before the first tag slot */
+#define REQUEST_GUARD_MS 2
+
+typedef struct {
+	uint32_t superframes;
+	uint32_t grants;
+	uint32_t releases;
+	uint32_t revokes;
+	uint32_t requests;
+	uint32_t out_of_slot;
+	uint32_t collisions;
+	uint32_t missed_beacons;
+	uint32_t overruns;
+} slots_stats_t;
+
+static sit_slot_table_t table;
+static slots_stats_t stats;
+// coordinator: last beacon sent, tag: last beacon received or predicted
+static int64_t beacon_time;
+static uint16_t slot_ms = CONFIG_SIT_SLOTS_SLOT_MS;
+static uint16_t superframe_ms = SUPERFRAME_MS;
+static bool synced;
+static uint8_t missed;
+static int16_t own_slot = -1;
+
+static bool is_coordinator(void) {
+	return device_settings.deviceID == SIT_SLOTS_COORDINATOR_ID;
+}
+
+static void report(void) {
+	if (++stats.superframes % REPORT_SUPERFRAMES != 0) {
+		return;
+	}
+	if (is_coordinator()) {
+		LOG_INF("Slots: %u/%u granted, %u grants, %u releases, %u revokes, %u polls out of slot, %u collisions",
+			sit_slot_table_used(&table), table.slots, stats.grants, stats.releases, stats.revokes, 
+			stats.out_of_slot, stats.collisions);
+	} else {
+		LOG_INF("Slot %d: %u requests, %u missed beacons, %u overruns",
+			own_slot, stats.requests, stats.missed_beacons, stats.overruns);
+	}
+}
+
+void sit_slots_reset(void) {
+	sit_slot_table_init(&table, CONFIG_SIT_SLOTS_COUNT);
+	stats = (slots_stats_t){0};
+	// the coordinator sends the first beacon right away
+	beacon_time = k_uptime_get() - SUPERFRAME_MS;
+	slot_ms = CONFIG_SIT_SLOTS_SLOT_MS;
+	superframe_ms = SUPERFRAME_MS;
+	synced = false;
+	missed = 0;
+	own_slot = -1;
+}
+
+uint32_t sit_slots_rx_timeout(uint32_t timeout) {
+	if (!is_coordinator()) {
+		return timeout;
+	}
+	int64_t remaining_ms = beacon_time + SUPERFRAME_MS - k_uptime_get();
+	// 0 disables the timeout, the shortest one is 1 UUS
+	uint32_t beacon_timeout = remaining_ms > 0 ? (uint32_t)remaining_ms * 1000 : 1;
+	return (timeout == 0 || beacon_timeout < timeout) ? beacon_timeout : timeout;
+}
+
+void sit_slots_frame(const header_t *header) {
+	if (!is_coordinator() || header->source >= SIT_SLOTS_COORDINATOR_ID) {
+		return;
+	}
+	switch (header->id) {
+	case slot_request: {
+		if (header->dest != device_settings.deviceID) {
+			break;
+		}
+		bool known = sit_slot_table_find(&table, header->source) >= 0;
+		int16_t slot = sit_slot_table_grant(&table, header->source);
+		if (slot < 0) {
+			LOG_WRN("No free slot for tag %u", header->source);
+		} else if (!known) {
+			stats.grants++;
+			LOG_INF("Slot %d granted to tag %u", slot, header->source);
+		}
+		break;
+	}
+	case slot_release:
+		if (sit_slot_table_release(&table, header->source)) {
+			stats.releases++;
+			LOG_INF("Tag %u released its slot", header->source);
+		}
+		break;
+	case twr_1_poll:
+	case ss_twr_1_poll: {
+		sit_slot_table_seen(&table, header->source);
+		int16_t slot = sit_slot_table_slot_at(&table, (uint32_t)(k_uptime_get() - beacon_time), slot_ms);
+		if (slot < 0 || table.owner[slot] != header->source) {
+			stats.out_of_slot++;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void sit_slots_service(void) {
+	if (!is_coordinator()) {
+		return;
+	}
+	int64_t now = k_uptime_get();
+	if (now - beacon_time < SUPERFRAME_MS) {
+		return;
+	}
+	uint8_t revoked = sit_slot_table_age(&table, CONFIG_SIT_SLOTS_REVOKE_SUPERFRAMES);
+	if (revoked > 0) {
+		stats.revokes += revoked;
+		LOG_INF("%u slots revoked", revoked);
+	}
+	msg_slot_beacon_t beacon = {
+		.header = {slot_beacon, (uint16_t)stats.superframes, device_settings.deviceID, SIT_ADDR_BROADCAST},
+		.slots = table.slots,
+		.slot_ms = CONFIG_SIT_SLOTS_SLOT_MS,
+	};
+	for (uint8_t i = 0; i < CONFIG_SIT_SLOTS_COUNT; i++) {
+		beacon.owner[i] = table.owner[i];
+	}
+	// the tags synchronise to the beacon, the slots start with the real send time
+	beacon_time = now;
+	sit_send_now((uint8_t*)&beacon, sizeof(beacon));
+	report();
+}
+
+void sit_slots_collision(void) {
+	stats.collisions++;
+	LOG_WRN("Final message of another exchange (%u collisions)", stats.collisions);
+}
+
+static bool receive_beacon(void) {
+	int64_t deadline;
+	if (synced) {
+		int64_t expected = beacon_time + superframe_ms;
+		int64_t wait_ms = expected - BEACON_GUARD_MS - k_uptime_get();
+		if (wait_ms > 0) {
+			k_msleep(wait_ms);
+		}
+		deadline = expected + slot_ms / 2;
+	} else {
+		deadline = k_uptime_get() + 2 * superframe_ms;
+	}
+	int64_t remaining_ms = deadline - k_uptime_get();
+	while (remaining_ms > 0) {
+		msg_slot_beacon_t beacon;
+		sit_receive_now(0, (uint32_t)remaining_ms * 1000);
+		if (sit_check_any_msg((uint8_t*)&beacon, sizeof(beacon))
+				&& beacon.header.id == slot_beacon
+				&& beacon.header.source == SIT_SLOTS_COORDINATOR_ID) {
+			beacon_time = k_uptime_get();
+			slot_ms = beacon.slot_ms;
+			superframe_ms = (MIN(beacon.slots, CONFIG_SIT_SLOTS_COUNT) + 1) * slot_ms;
+			synced = true;
+			missed = 0;
+			int16_t slot = -1;
+			for (uint8_t i = 0; i < MIN(beacon.slots, CONFIG_SIT_SLOTS_COUNT); i++) {
+				if (beacon.owner[i] == device_settings.deviceID) {
+					slot = i;
+				}
+			}
+			if (slot != own_slot) {
+				LOG_INF(slot < 0 ? "Slot %d revoked" : "Slot %d granted", slot < 0 ? own_slot : slot);
+			}
+			own_slot = slot;
+			return true;
+		}
+		remaining_ms = deadline - k_uptime_get();
+	}
+	return false;
+}
+
+static void request_slot(void) {
+	// random start in the beacon slot, colliding requests are repeated in the next superframe
+	uint32_t window_us = (slot_ms - REQUEST_GUARD_MS) * 1000;
+	k_usleep(sys_rand32_get() % window_us);
+	msg_simple_t request = {{slot_request, (uint16_t)stats.requests, device_settings.deviceID, SIT_SLOTS_COORDINATOR_ID}, 0};
+	sit_send_now((uint8_t*)&request, sizeof(request));
+	stats.requests++;
+}
+
+bool sit_slots_wait(void) {
+	if (synced && own_slot >= 0 && k_uptime_get() > beacon_time + (own_slot + 2) * slot_ms) {
+		// the ranging cycle of the tag is longer than its slot
+		stats.overruns++;
+	}
+	while (device_settings.state == measurement) {
+		if (!receive_beacon()) {
+			if (!synced) {
+				continue;
+			}
+			stats.missed_beacons++;
+			beacon_time += superframe_ms;
+			if (++missed > MAX_MISSED_BEACONS) {
+				LOG_WRN("Beacon lost, slot %d given up", own_slot);
+				synced = false;
+				own_slot = -1;
+				continue;
+			}
+		}
+		report();
+		if (own_slot < 0) {
+			request_slot();
+			continue;
+		}
+		int64_t wait_ms = beacon_time + (own_slot + 1) * slot_ms - k_uptime_get();
+		if (wait_ms > 0) {
+			k_msleep(wait_ms);
+		}
+		return true;
+	}
+	return false;
+}
+
+uint32_t sit_slots_remaining_us(void) {
+	if (!synced || own_slot < 0) {
+		return 0;
+	}
+	int64_t remaining_ms = beacon_time + (own_slot + 2) * slot_ms - k_uptime_get();
+	return remaining_ms > 0 ? (uint32_t)remaining_ms * 1000 : 0;
+}
+
+void sit_slots_release(void) {
+	if (own_slot < 0) {
+		return;
+	}
+	msg_simple_t release = {{slot_release, (uint16_t)stats.requests, device_settings.deviceID, SIT_SLOTS_COORDINATOR_ID}, 0};
+	sit_send_now((uint8_t*)&release, sizeof(release));
+	own_slot = -1;
+	synced = false;
+}
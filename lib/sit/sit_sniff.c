@@ -0,0 +1,112 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_sniff.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the sniff mode for idle responders.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_sniff.h"
+#include "sit/sit_distance.h"
+
+#include <string.h>
+
+#include <deca_device_api.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_SNIFF, LOG_LEVEL_INF);
+
+#define SIT_SNIFF_MINUTE_MS 60000
+
+static sit_sniff_stats_t sniff_stats;
+static bool sniff_active;
+static int64_t mode_since;
+static int64_t last_traffic;
+static int64_t minute_start;
+static uint32_t minute_wakeups;
+
+static void account_mode_time(int64_t now) {
+	if (sniff_active) {
+		sniff_stats.sniff_ms += now - mode_since;
+	} else {
+		sniff_stats.full_ms += now - mode_since;
+	}
+	mode_since = now;
+}
+
+static void set_sniff(bool enable) {
+	int64_t now = k_uptime_get();
+	account_mode_time(now);
+	sniff_active = enable;
+	if (enable) {
+		dwt_setsniffmode(1, CONFIG_SIT_SNIFF_ON_PAC, CONFIG_SIT_SNIFF_OFF_US);
+		LOG_INF("Sniff mode on");
+	} else {
+		dwt_setsniffmode(0, 0, 0);
+		sniff_stats.wakeups++;
+		minute_wakeups++;
+		LOG_INF("Sniff mode off");
+	}
+}
+
+void sit_sniff_reset(void) {
+	memset(&sniff_stats, 0, sizeof(sniff_stats));
+	dwt_setsniffmode(0, 0, 0);
+	sniff_active = false;
+	mode_since = k_uptime_get();
+	last_traffic = mode_since;
+	minute_start = mode_since;
+	minute_wakeups = 0;
+}
+
+void sit_sniff_receive(void) {
+	// rx timeout in uus, 0 waits for the next frame
+	sit_receive_now(0, sniff_active ? 0 : CONFIG_SIT_SNIFF_IDLE_MS * 1000);
+}
+
+void sit_sniff_update(bool traffic) {
+	int64_t now = k_uptime_get();
+	if (traffic) {
+		last_traffic = now;
+		if (sniff_active) {
+			set_sniff(false);
+		}
+	} else if (!sniff_active && now - last_traffic >= CONFIG_SIT_SNIFF_IDLE_MS) {
+		set_sniff(true);
+	}
+
+	if (now - minute_start >= SIT_SNIFF_MINUTE_MS) {
+		account_mode_time(now);
+		sniff_stats.wakeups_per_minute = minute_wakeups;
+		LOG_INF("Sniff: %u wake ups/min, sniff %u%%", minute_wakeups,
+			(uint32_t)(sniff_stats.sniff_ms * 100 / MAX(sniff_stats.sniff_ms + sniff_stats.full_ms, 1)));
+		minute_wakeups = 0;
+		minute_start = now;
+	}
+}
+
+void sit_sniff_get_stats(sit_sniff_stats_t *stats) {
+	account_mode_time(k_uptime_get());
+	*stats = sniff_stats;
+}
@@ -0,0 +1,263 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+/**
+ * @file sit_survey.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the anchor auto-survey.
+ *
+ * Protocol (anchor ids 100 .. device_settings.responder):
+ * 1. The anchor with the token polls every other anchor
+ *    CONFIG_SIT_SURVEY_MEASUREMENTS times, the polled anchors calculate 
+ *    and average the distance.
+ * 2. The token is passed to the next anchor, the last anchor passes it
+ *    back to anchor 100.
+ * 3. Anchor 100 requests the averaged distances of every anchor 
+ *    (survey_report), solves the positions and sends survey_done.
+ *
+ * If the token is lost, anchor 100 continues with the collection after
+ * SIT_SURVEY_TOKEN_TIMEOUT_MS. Pairs without a distance are filled by the
+ * solver as long as the anchors are connected.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_survey.h"
+#include "sit/sit.h"
+#include "sit/sit_config.h"
+#include "sit/sit_distance.h"
+#include "sit/sit_mds.h"
+
+#include <sit_ble/ble_init.h>
+
+#include <string.h>
+
+#include <deca_device_api.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_SURVEY, LOG_LEVEL_INF);
+
+#define SIT_SURVEY_BROADCAST SIT_ADDR_BROADCAST
+#define SIT_SURVEY_RX_TIMEOUT_UUS 50000
+#define SIT_SURVEY_REPORT_TIMEOUT_UUS 10000
+#define SIT_SURVEY_TOKEN_TIMEOUT_MS 5000
+#define SIT_SURVEY_TOKEN_DELAY_MS 10
+#define SIT_SURVEY_REPORT_RETRIES 3
+
+#define N SIT_MDS_MAX_ANCHORS
+
+static float distance_sum[N];
+static uint16_t distance_count[N];
+static float distance_matrix[N * N];
+static bool survey_done_received;
+static sit_session_t survey_session;
+
+static uint8_t survey_anchors(void) {
+	if (device_settings.responder < SIT_SURVEY_MASTER_ID) {
+		return 0;
+	}
+	uint16_t anchors = device_settings.responder - SIT_SURVEY_MASTER_ID + 1;
+	return MIN(anchors, N);
+}
+
+/* Map an address to the survey index, false if it is no survey anchor. */
+static bool survey_index(sit_addr_t address, uint8_t *index) {
+	if (address < SIT_SURVEY_MASTER_ID || address - SIT_SURVEY_MASTER_ID >= survey_anchors()) {
+		return false;
+	}
+	*index = address - SIT_SURVEY_MASTER_ID;
+	return true;
+}
+
+static void reset_survey(void) {
+	memset(distance_sum, 0, sizeof(distance_sum));
+	memset(distance_count, 0, sizeof(distance_count));
+	memset(distance_matrix, 0, sizeof(distance_matrix));
+	survey_done_received = false;
+	survey_session = (sit_session_t){0};
+}
+
+static void send_simple(msg_id_t id, sit_addr_t dest) {
+	msg_simple_t msg = {{id, (uint16_t)survey_session.sequence, device_settings.deviceID, dest}, 0};
+	sit_send_now((uint8_t*)&msg, sizeof(msg));
+}
+
+static void get_report(msg_survey_report_t *report) {
+	for (uint8_t i = 0; i < N; i++) {
+		float mean = distance_count[i] > 0 ? distance_sum[i] / distance_count[i] : 0.0f;
+		report->distance_cm[i] = (uint16_t)CLAMP(mean * 100.0f + 0.5f, 0.0f, (float)UINT16_MAX);
+	}
+}
+
+static void set_row(uint8_t index, const msg_survey_report_t *report) {
+	uint8_t anchors = survey_anchors();
+	for (uint8_t i = 0; i < anchors; i++) {
+		distance_matrix[index * anchors + i] = report->distance_cm[i] / 100.0f;
+	}
+}
+
+/* Poll every other anchor, the distance is calculated and stored by them. */
+static void survey_turn(void) {
+	uint8_t anchors = survey_anchors();
+	k_msleep(SIT_SURVEY_TOKEN_DELAY_MS);
+	for (uint8_t m = 0; m < CONFIG_SIT_SURVEY_MEASUREMENTS; m++) {
+		for (uint8_t i = 0; i < anchors; i++) {
+			sit_addr_t anchor_id = SIT_SURVEY_MASTER_ID + i;
+			if (anchor_id == device_settings.deviceID) {
+				continue;
+			}
+			sit_dstwr_poll(&survey_session, anchor_id);
+			k_msleep(SIT_SURVEY_TOKEN_DELAY_MS);
+		}
+		survey_session.sequence++;
+	}
+	sit_addr_t next = device_settings.deviceID + 1;
+	if (next >= SIT_SURVEY_MASTER_ID + anchors) {
+		next = SIT_SURVEY_MASTER_ID;
+	}
+	send_simple(survey_token, next);
+}
+
+/* Handle one received msg, returns true if this anchor got the token. */
+static bool survey_handle_msg(uint8_t *rx_buffer) {
+	header_t *header = (header_t*)rx_buffer;
+	if (header->dest != device_settings.deviceID && header->dest != SIT_SURVEY_BROADCAST) {
+		return false;
+	}
+	uint8_t source = 0;
+	bool known_source = survey_index(header->source, &source);
+	switch (header->id) {
+	case twr_1_poll:
+		if (known_source && sit_dstwr_response(&survey_session, (msg_simple_t*)rx_buffer) 
+				&& survey_session.distance > 0.0) {
+			distance_sum[source] += (float)survey_session.distance;
+			distance_count[source]++;
+		}
+		break;
+	case survey_token:
+		return true;
+	case survey_report_request: {
+		msg_survey_report_t report = {{survey_report, header->sequence, device_settings.deviceID, header->source}, {0}, 0};
+		get_report(&report);
+		sit_send_now((uint8_t*)&report, sizeof(report));
+		break;
+	}
+	case survey_done:
+		survey_done_received = true;
+		break;
+	default:
+		break;
+	}
+	return false;
+}
+
+/* Listen until the token arrives, the survey is done or the timeout (0: none) */
+static bool survey_listen(int64_t timeout_ms) {
+	uint8_t rx_buffer[sizeof(msg_survey_report_t)];
+	int64_t start = k_uptime_get();
+	while (device_settings.state == measurement && !survey_done_received) {
+		if (timeout_ms > 0 && k_uptime_get() - start > timeout_ms) {
+			return false;
+		}
+		sit_receive_now(0, timeout_ms > 0 ? SIT_SURVEY_RX_TIMEOUT_UUS : 0);
+		if (sit_check_any_msg(rx_buffer, sizeof(rx_buffer)) && survey_handle_msg(rx_buffer)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void survey_collect(void) {
+	uint8_t anchors = survey_anchors();
+	msg_survey_report_t report;
+	get_report(&report);
+	set_row(0, &report);
+	for (uint8_t i = 1; i < anchors; i++) {
+		for (uint8_t retry = 0; retry < SIT_SURVEY_REPORT_RETRIES; retry++) {
+			msg_simple_t request = {{survey_report_request, (uint16_t)survey_session.sequence, device_settings.deviceID, SIT_SURVEY_MASTER_ID + i}, 0};
+			sit_set_rx_after_tx_delay(0);
+			sit_set_rx_timeout(SIT_SURVEY_REPORT_TIMEOUT_UUS);
+			sit_set_preamble_detection_timeout(0);
+			sit_start_poll((uint8_t*)&request, sizeof(request));
+			if (sit_check_survey_report_msg_id(survey_report, &report) 
+					&& report.header.source == SIT_SURVEY_MASTER_ID + i) {
+				set_row(i, &report);
+				break;
+			}
+			LOG_WRN("No survey report from anchor %u", SIT_SURVEY_MASTER_ID + i);
+		}
+	}
+}
+
+static void survey_solve(void) {
+	uint8_t anchors = survey_anchors();
+	sit_vec3_t positions[N];
+	float rms = sit_mds_solve(distance_matrix, anchors, IS_ENABLED(CONFIG_SIT_SURVEY_3D), positions);
+	if (rms < 0.0f) {
+		LOG_ERR("Survey failed, not enough anchor distances");
+		return;
+	}
+	LOG_INF("Survey RMS: %3.3f", rms);
+	for (uint8_t i = 0; i < anchors; i++) {
+		LOG_INF("Anchor %u: %3.2f %3.2f %3.2f", SIT_SURVEY_MASTER_ID + i, 
+			positions[i].x, positions[i].y, positions[i].z);
+		json_position_msg_t survey_notify = {
+			.header = {
+				.type = "survey_msg",
+				.sequence = SIT_SURVEY_MASTER_ID + i,
+				.measurements = anchors,
+			},
+			.data = {
+				.x = positions[i].x,
+				.y = positions[i].y,
+				.z = positions[i].z,
+				.quality = rms,
+				.anchors = anchors,
+				.iterations = 0,
+			}
+		};
+		ble_sit_position_notify(&survey_notify, sizeof(survey_notify));
+		k_msleep(SIT_SURVEY_TOKEN_DELAY_MS);
+	}
+}
+
+void sit_survey_run(void) {
+	reset_survey();
+	if (device_settings.deviceID == SIT_SURVEY_MASTER_ID) {
+		// give the other anchors time to start listening
+		k_msleep(100);
+		survey_turn();
+		uint8_t anchors = survey_anchors();
+		if (!survey_listen((int64_t)SIT_SURVEY_TOKEN_TIMEOUT_MS * anchors)) {
+			LOG_WRN("Survey token lost, collect the available distances");
+		}
+		survey_collect();
+		send_simple(survey_done, SIT_SURVEY_BROADCAST);
+		survey_solve();
+	} else {
+		while (device_settings.state == measurement && !survey_done_received) {
+			if (survey_listen(0)) {
+				survey_turn();
+			}
+		}
+	}
+	device_settings.state = sleep;
+}
@@ -0,0 +1,102 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_temp.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the temperature compensation.
+ *
+ * dwt_calcbandwidthadj() needs the PLL in IDLE, so the transceiver is
+ * switched off first. The antenna delay offset is applied to the RX and
+ * TX delay, the stored (calibrated) delays in device_settings are not
+ * changed.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_temp.h"
+#include "sit/sit_config.h"
+#include "sit/sit_device.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(SIT_TEMP, LOG_LEVEL_INF);
+
+static dwt_txconfig_t *txconfig;
+static uint16_t reference_pgcount;
+static float reference_temp;
+static float last_temp;
+static int16_t ant_dly_offset;
+static int64_t last_run;
+
+static float read_temperature(void) {
+	uint16_t temp_vbat = dwt_readtempvbat();
+	return dwt_convertrawtemperature((uint8_t)(temp_vbat >> 8));
+}
+
+static uint16_t add_offset(uint16_t delay, int16_t offset) {
+	int32_t result = (int32_t)delay + offset;
+	return (uint16_t)CLAMP(result, 0, UINT16_MAX);
+}
+
+void sit_temp_init(dwt_txconfig_t *config) {
+	txconfig = config;
+	reference_pgcount = dwt_calcpgcount(config->PGdly);
+	config->PGcount = reference_pgcount;
+	reference_temp = read_temperature();
+	last_temp = reference_temp;
+	ant_dly_offset = 0;
+	last_run = k_uptime_get();
+	LOG_INF("Temperature reference: %.1f C, PG count %u", (double)reference_temp, reference_pgcount);
+}
+
+void sit_temp_apply(void) {
+	if (txconfig == NULL) {
+		return;
+	}
+	dwt_configuretxrf(txconfig);
+	set_antenna_delay(
+		add_offset(device_settings.rx_ant_dly, ant_dly_offset),
+		add_offset(device_settings.tx_ant_dly, ant_dly_offset));
+}
+
+bool sit_temp_service(int64_t idle_ms) {
+	int64_t now = k_uptime_get();
+	if (txconfig == NULL || idle_ms < CONFIG_SIT_TEMP_MIN_IDLE_MS 
+			|| now - last_run < CONFIG_SIT_TEMP_PERIOD_MS) {
+		return false;
+	}
+	last_run = now;
+
+	dwt_forcetrxoff();
+	last_temp = read_temperature();
+	txconfig->PGdly = dwt_calcbandwidthadj(reference_pgcount);
+	ant_dly_offset = (int16_t)(device_settings.ant_dly_temp_coeff * (last_temp - reference_temp));
+	sit_temp_apply();
+
+	LOG_INF("Temperature %.1f C: PG delay 0x%02x, antenna delay offset %d", 
+		(double)last_temp, txconfig->PGdly, ant_dly_offset);
+	return true;
+}
+
+float sit_temp_get(void) {
+	return last_temp;
+}
@@ -65,3 +65,24 @@ uint64_t get_rx_timestamp_u64(void)
 	return ts;
 }
 
+void set_timestamp_u40(uint8_t *field, uint64_t ts)
+{
+	int i;
+
+	for (i = 0; i < 5; i++) {
+		field[i] = (uint8_t)ts;
+		ts >>= 8;
+	}
+}
+
+uint64_t get_timestamp_u40(const uint8_t *field)
+{
+	uint64_t ts = 0;
+	int i;
+
+	for (i = 4; i >= 0; i--) {
+		ts <<= 8;
+		ts |= field[i];
+	}
+	return ts;
+}
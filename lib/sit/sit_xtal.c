@@ -0,0 +1,106 @@
+/**********************************************************************************
+ *
+ *  Copyright (C) 2026  agent
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+***********************************************************************************/
+
+
+/**
+ * @file sit_xtal.c
+ * @author agent
+ * @date 19.10.2026
+ * @brief Implementation of the closed loop crystal trim.
+ *
+ * A higher trim value adds load capacitance and slows the clock down, so
+ * a positive offset (local clock slower) needs a lower trim. A slope
+ * estimate with the wrong sign flips the direction.
+ *
+ * @bug No known bugs.
+ */
+
+#include "sit/sit_xtal.h"
+
+#include <math.h>
+
+#define SIT_XTAL_TARGET_PPM     (CONFIG_SIT_XTAL_TARGET_PPM_X10 / 10.0f)
+#define SIT_XTAL_MIN_SLOPE      0.2f
+#define SIT_XTAL_MAX_SLOPE      10.0f
+
+void sit_xtal_reset(sit_xtal_t *xtal, uint8_t trim) {
+    xtal->trim = trim > SIT_XTAL_TRIM_MAX ? SIT_XTAL_TRIM_MAX : trim;
+    xtal->converged = false;
+    xtal->ppm_per_step = SIT_XTAL_PPM_PER_STEP;
+    xtal->sum = 0.0f;
+    xtal->samples = 0;
+    xtal->last_mean = 0.0f;
+    xtal->last_step = 0;
+}
+
+static void update_slope(sit_xtal_t *xtal, float mean) {
+    float slope = (mean - xtal->last_mean) / xtal->last_step;
+    float magnitude = fabsf(slope);
+    if (magnitude < SIT_XTAL_MIN_SLOPE || magnitude > SIT_XTAL_MAX_SLOPE) {
+        // noise or a jump of the reference, keep the estimate
+        return;
+    }
+    if ((slope > 0.0f) != (xtal->ppm_per_step > 0.0f)) {
+        xtal->ppm_per_step = slope;
+    } else {
+        xtal->ppm_per_step = (xtal->ppm_per_step + slope) / 2.0f;
+    }
+}
+
+bool sit_xtal_update(sit_xtal_t *xtal, float offset_ppm) {
+    xtal->sum += offset_ppm;
+    if (++xtal->samples < CONFIG_SIT_XTAL_SAMPLES) {
+        return false;
+    }
+    float mean = xtal->sum / xtal->samples;
+    xtal->sum = 0.0f;
+    xtal->samples = 0;
+
+    if (xtal->last_step != 0) {
+        update_slope(xtal, mean);
+    }
+    xtal->last_mean = mean;
+    xtal->last_step = 0;
+
+    if (fabsf(mean) <= SIT_XTAL_TARGET_PPM) {
+        xtal->converged = true;
+        return false;
+    }
+    // hysteresis, a converged trim is only changed at twice the target
+    if (xtal->converged && fabsf(mean) <= 2.0f * SIT_XTAL_TARGET_PPM) {
+        return false;
+    }
+    xtal->converged = false;
+
+    int32_t step = (int32_t)lroundf(-mean / xtal->ppm_per_step);
+    if (step > SIT_XTAL_MAX_STEP) {
+        step = SIT_XTAL_MAX_STEP;
+    } else if (step < -SIT_XTAL_MAX_STEP) {
+        step = -SIT_XTAL_MAX_STEP;
+    }
+    int32_t trim = (int32_t)xtal->trim + step;
+    if (trim < 0) {
+        trim = 0;
+    } else if (trim > SIT_XTAL_TRIM_MAX) {
+        trim = SIT_XTAL_TRIM_MAX;
+    }
+    xtal->last_step = (int8_t)(trim - xtal->trim);
+    xtal->trim = (uint8_t)trim;
+    return xtal->last_step != 0;
+}
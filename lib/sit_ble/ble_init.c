@@ -38,6 +38,15 @@
 #include <sit/sit.h>
 #include <sit_json/sit_json.h>
 #include <sit/sit_device.h>
+#ifdef CONFIG_SIT_POSITION
+	#include <sit/sit_position.h>
+#endif
+#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+	#include <sit/sit_diagnostic.h>
+#endif
+#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+	#include <sit/sit_all_twr.h>
+#endif
 
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
@@ -58,6 +67,7 @@
 LOG_MODULE_REGISTER(BLE_INIT, LOG_LEVEL_INF);
 
 #include "sit_ble/ble_init.h"
+#include <sit/sit_boot.h>
 #include "sit_ble/cts.h"
 
 #define POS_MAX_LEN 20
@@ -65,7 +75,7 @@ LOG_MODULE_REGISTER(BLE_INIT, LOG_LEVEL_INF);
 struct bt_conn *default_conn;
 bool connection_status = false;
 
-static int sit_position = 100U;
+static json_position_msg_t sit_position;
 
 static struct bt_uuid_128 sit_uuid = BT_UUID_INIT_128(
 	BT_UUID_SIT_SERVICE_VAL);
@@ -129,7 +139,7 @@ static ssize_t write_json_comand(
 				LOG_INF("Start Measurement");
 				reset_sequence();
 				set_device_state(command_str.command);
-			} else if(strcmp(command_str.command, "stop") == 0 && device_type == initiator && device_settings.min_measurement != 0 && device_settings.min_measurement > measurements) {
+			} else if(strcmp(command_str.command, "stop") == 0 && device_type == initiator && device_settings.min_measurement != 0 && device_settings.min_measurement > initiator_session.measurements) {
 				set_max_measurement(device_settings.min_measurement);
 			} else { 
 				set_device_state(command_str.command);
@@ -151,7 +161,9 @@ static ssize_t write_json_setup(
 		uint8_t flags
 	) {
 	const char* value = (const char*)buf;
-	json_setup_msg_t setup_str;
+	// too large for the BT RX stack, the callbacks run one at a time on the RX thread
+	static json_setup_msg_t setup_str;
+	memset(&setup_str, 0, sizeof(setup_str));
 
 	int ret = json_decode_setup_msg(value, &setup_str);
 
@@ -167,15 +179,56 @@ static ssize_t write_json_setup(
 		set_rx_ant_dly(setup_str.rx_ant_dly);
 		set_tx_ant_dly(setup_str.tx_ant_dly);
 		set_device_type(setup_str.device_type);
+		set_calibration_distance(
+			setup_str.calibration_distance[0], 
+			setup_str.calibration_distance[1], 
+			setup_str.calibration_distance[2]);
+		if (setup_str.ant_dly_temp_coeff_set) {
+			set_ant_dly_temp_coeff(setup_str.ant_dly_temp_coeff);
+		}
+		#ifdef CONFIG_SIT_NLOS_CLASSIFIER
+			if (setup_str.nlos_model) {
+				set_nlos_model(
+					setup_str.nlos_mean,
+					setup_str.nlos_scale,
+					setup_str.nlos_weight,
+					setup_str.nlos_bias);
+			}
+		#endif
+		#ifdef CONFIG_SIT_EXTENDED_CALIBRATION
+			for (uint8_t i = 0; i < setup_str.calibration_positions; i++) {
+				sit_all_twr_set_calibration_position(i, 
+					setup_str.calibration_position[i][0], 
+					setup_str.calibration_position[i][1], 
+					setup_str.calibration_position[i][2]);
+			}
+		#endif
+		#ifdef CONFIG_SIT_POSITION
+			sit_position_clear();
+			for (uint8_t i = 0; i < setup_str.anchors; i++) {
+				sit_position_set_anchor(i, 
+					setup_str.anchor_position[i][0], 
+					setup_str.anchor_position[i][1], 
+					setup_str.anchor_position[i][2]);
+			}
+		#endif
 		if (strncmp(setup_str.initiator_device, bt_get_name(), 16) == 0 ){
 			LOG_INF("Test Initiator");
-			set_device_id(1);
+			if (setup_str.tag_id >= 1 && setup_str.tag_id <= SIT_TAG_ADDR_MAX) {
+				set_device_id(setup_str.tag_id);
+			} else {
+				if (setup_str.tag_id != 0) {
+					LOG_ERR("Tag ID %u out of range", setup_str.tag_id);
+				}
+				set_device_id(get_tag_address());
+			}
 			set_responder(100 + setup_str.responder - 1);
 		} else if (strlen(setup_str.responder_device[0]) > 0) {
-			for(uint8_t i=0; i<setup_str.responder; i++) {
+			for(uint16_t i=0; i<setup_str.responder && i<JSON_MAX_ANCHORS; i++) {
 				if (strncmp(setup_str.responder_device[i], bt_get_name(), 16) == 0 ) {
 					LOG_INF("Test Responder");
 					set_device_id(100 + i);
+					set_responder(100 + setup_str.responder - 1);
 					break;
 				}  else {
 					LOG_ERR("Setup: %s", setup_str.type);
@@ -283,11 +336,26 @@ static void bt_ready(void)
 	ble_device_name();
 	// ble_device_address();
 
-	if (IS_ENABLED(CONFIG_SETTINGS)) {
+	if (IS_ENABLED(CONFIG_SIT_SETTINGS)) {
+		// the sit subtree is already restored by sit_settings_init()
+		settings_load_subtree("bt");
+	} else if (IS_ENABLED(CONFIG_SETTINGS)) {
 		settings_load();
 	}
+	sit_boot_mark(boot_ble);
 }
 
+#ifdef CONFIG_SIT_FAST_BOOT
+static void bt_ready_cb(int err) {
+	if (err) {
+		LOG_ERR("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+	bt_ready();
+	ble_start_advertising();
+}
+#endif
+
 int ble_start_advertising(){
 	int err;
 
@@ -347,17 +415,37 @@ void ble_sit_td_notify(json_simple_td_msg_t *json_data, size_t data_len) {
 	bt_gatt_notify(NULL, &sit_service.attrs[1], json_data, data_len);
 }
 
+void ble_sit_calibration_notify(json_calibration_msg_t *json_data, size_t data_len) {
+	bt_gatt_notify(NULL, &sit_service.attrs[1], json_data, data_len);
+}
+
+int ble_sit_cir_notify(const void *data, size_t data_len) {
+	return bt_gatt_notify(NULL, &sit_service.attrs[1], data, data_len);
+}
+
+void ble_sit_position_notify(json_position_msg_t *json_data, size_t data_len) {
+	memcpy(&sit_position, json_data, MIN(data_len, sizeof(sit_position)));
+	bt_gatt_notify(NULL, &sit_service.attrs[1], json_data, data_len);
+}
+
 uint8_t sit_ble_init(void){
 	int err;
-	err = bt_enable(NULL);
+	bt_conn_cb_register(&conn_callbacks);
+	bt_conn_auth_cb_register(&auth_cb_display);
+
+	#ifdef CONFIG_SIT_FAST_BOOT
+		// BLE comes up in the background while the DW3000 is initialized
+		err = bt_enable(bt_ready_cb);
+	#else
+		err = bt_enable(NULL);
+	#endif
 	if (err) {
 		LOG_ERR("Bluetooth init failed (err %d)\n", err);
 		return err;
 	}
-	bt_ready();
-
-	bt_conn_cb_register(&conn_callbacks);
-	bt_conn_auth_cb_register(&auth_cb_display);
+	#ifndef CONFIG_SIT_FAST_BOOT
+		bt_ready();
+	#endif
 
 	return 0;
 }
\ No newline at end of file
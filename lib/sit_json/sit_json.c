@@ -79,20 +79,43 @@ int json_decode_state_msg(char *json, json_command_msg_t *command_struct) {
     return 0;
 }
 
+/* Array of three numbers ([x, y, z] or three distances), false for anything else */
+static bool json_get_position(const cJSON *item, float *position) {
+    if (!cJSON_IsArray(item) || cJSON_GetArraySize(item) != 3) {
+        return false;
+    }
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        const cJSON *value = cJSON_GetArrayItem(item, axis);
+        if (!cJSON_IsNumber(value)) {
+            return false;
+        }
+        position[axis] = (float)value->valuedouble;
+    }
+    return true;
+}
+
 int json_decode_setup_msg(char *json, json_setup_msg_t *setup_struct) {
 
     const cJSON *type = NULL;
     const cJSON *device_type = NULL;
     const cJSON *initiator_device = NULL;
     const cJSON *initiator = NULL;
+    const cJSON *tag_id = NULL;
     const cJSON *responder_list = NULL;
     const cJSON *responder_device = NULL;
     const cJSON *responder = NULL;
+    const cJSON *anchor_list = NULL;
+    const cJSON *anchor_position = NULL;
+    const cJSON *calibration_distance = NULL;
+    const cJSON *calibration_list = NULL;
+    const cJSON *calibration_position = NULL;
     const cJSON *min_measurement = NULL;
     const cJSON *max_measurement = NULL;
     const cJSON *measurement_type = NULL;
     const cJSON *rx_ant_dly = NULL;
     const cJSON *tx_ant_dly = NULL;
+    const cJSON *nlos_model = NULL;
+    const cJSON *ant_dly_temp_coeff = NULL;
     cJSON *json_msg = cJSON_Parse(json);
     if (json_msg == NULL) {
         const char *error_ptr = cJSON_GetErrorPtr();
@@ -130,9 +153,17 @@ int json_decode_setup_msg(char *json, json_setup_msg_t *setup_struct) {
     initiator = cJSON_GetObjectItemCaseSensitive(json_msg, "initiator");
     setup_struct->initiator = initiator->valueint;
 
+    // optional: address of the tag, 0 takes the address from the hardware id
+    tag_id = cJSON_GetObjectItemCaseSensitive(json_msg, "tag_id");
+    setup_struct->tag_id = cJSON_IsNumber(tag_id) ? tag_id->valueint : 0;
+
     responder_list = cJSON_GetObjectItemCaseSensitive(json_msg, "responder_device");
     uint8_t index = 0;
     cJSON_ArrayForEach(responder_device, responder_list) {
+        if (index >= JSON_MAX_ANCHORS) {
+            LOG_ERR("Too many responder devices");
+            break;
+        }
         if (cJSON_IsString(responder_device) && (responder_device->valuestring != NULL)) {
             LOG_INF("Checking responder_device \"%s\"\n", responder_device->valuestring);
             strcpy(setup_struct->responder_device[index], responder_device->valuestring);
@@ -143,8 +174,89 @@ int json_decode_setup_msg(char *json, json_setup_msg_t *setup_struct) {
     }
 
     responder = cJSON_GetObjectItemCaseSensitive(json_msg, "responder");
-    setup_struct->responder = responder->valueint;
+    // the last responder address (100 + responder - 1) must not be the broadcast address
+    if (!cJSON_IsNumber(responder) || responder->valueint < 0 || responder->valueint > UINT16_MAX - 100) {
+        LOG_ERR("Something responder wrong, setup rejected");
+        cJSON_Delete(json_msg);
+        return -2;
+    }
+    setup_struct->responder = (uint16_t)responder->valueint;
+
+    // optional: anchor coordinates [[x, y, z], ...] in order of responder_device
+    setup_struct->anchors = 0;
+    anchor_list = cJSON_GetObjectItemCaseSensitive(json_msg, "anchor_position");
+    cJSON_ArrayForEach(anchor_position, anchor_list) {
+        if (setup_struct->anchors >= JSON_MAX_ANCHORS) {
+            LOG_ERR("Too many anchor positions");
+            break;
+        }
+        if (!json_get_position(anchor_position, setup_struct->anchor_position[setup_struct->anchors])) {
+            // skipping it would shift all following anchors against responder_device
+            LOG_ERR("Something anchor position wrong, setup rejected");
+            cJSON_Delete(json_msg);
+            return -2;
+        }
+        setup_struct->anchors++;
+    }
+
+    // optional: known distances [A-B, A-C, B-C] for the two device calibration
+    memset(setup_struct->calibration_distance, 0, sizeof(setup_struct->calibration_distance));
+    calibration_distance = cJSON_GetObjectItemCaseSensitive(json_msg, "calibration_distance");
+    if (calibration_distance != NULL && !json_get_position(calibration_distance, setup_struct->calibration_distance)) {
+        LOG_ERR("Something calibration distance wrong, setup rejected");
+        cJSON_Delete(json_msg);
+        return -2;
+    }
+
+    // optional: node positions [[x, y, z], ...] for the extended calibration
+    setup_struct->calibration_positions = 0;
+    calibration_list = cJSON_GetObjectItemCaseSensitive(json_msg, "calibration_position");
+    cJSON_ArrayForEach(calibration_position, calibration_list) {
+        if (setup_struct->calibration_positions >= JSON_CALIBRATION_MAX_DEVICES) {
+            LOG_ERR("Too many calibration positions");
+            break;
+        }
+        if (!json_get_position(calibration_position, 
+                setup_struct->calibration_position[setup_struct->calibration_positions])) {
+            // the order is the node order of the calibration, skipping would shift it
+            LOG_ERR("Something calibration position wrong, setup rejected");
+            cJSON_Delete(json_msg);
+            return -2;
+        }
+        setup_struct->calibration_positions++;
+    }
     
+    // optional: antenna delay temperature coefficient in DWT time units per degree Celsius
+    ant_dly_temp_coeff = cJSON_GetObjectItemCaseSensitive(json_msg, "ant_dly_temp_coeff");
+    setup_struct->ant_dly_temp_coeff_set = cJSON_IsNumber(ant_dly_temp_coeff);
+    if (setup_struct->ant_dly_temp_coeff_set) {
+        setup_struct->ant_dly_temp_coeff = (float)ant_dly_temp_coeff->valuedouble;
+    }
+
+    // optional: NLOS classifier trained offline
+    setup_struct->nlos_model = false;
+    nlos_model = cJSON_GetObjectItemCaseSensitive(json_msg, "nlos_model");
+    if (cJSON_IsObject(nlos_model)) {
+        const cJSON *mean = cJSON_GetObjectItemCaseSensitive(nlos_model, "mean");
+        const cJSON *scale = cJSON_GetObjectItemCaseSensitive(nlos_model, "scale");
+        const cJSON *weight = cJSON_GetObjectItemCaseSensitive(nlos_model, "weight");
+        const cJSON *bias = cJSON_GetObjectItemCaseSensitive(nlos_model, "bias");
+        if (cJSON_GetArraySize(mean) == SIT_NLOS_FEATURES 
+                && cJSON_GetArraySize(scale) == SIT_NLOS_FEATURES
+                && cJSON_GetArraySize(weight) == SIT_NLOS_FEATURES
+                && cJSON_IsNumber(bias)) {
+            for (uint8_t i = 0; i < SIT_NLOS_FEATURES; i++) {
+                setup_struct->nlos_mean[i] = (float)cJSON_GetArrayItem(mean, i)->valuedouble;
+                setup_struct->nlos_scale[i] = (float)cJSON_GetArrayItem(scale, i)->valuedouble;
+                setup_struct->nlos_weight[i] = (float)cJSON_GetArrayItem(weight, i)->valuedouble;
+            }
+            setup_struct->nlos_bias = (float)bias->valuedouble;
+            setup_struct->nlos_model = true;
+        } else {
+            LOG_ERR("NLOS model needs %d features", SIT_NLOS_FEATURES);
+        }
+    }
+
     min_measurement = cJSON_GetObjectItemCaseSensitive(json_msg, "min_measurement");
     setup_struct->min_measurement = min_measurement->valueint;
 
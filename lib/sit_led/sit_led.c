@@ -19,12 +19,28 @@ static const struct gpio_dt_spec led2 = GPIO_DT_SPEC_GET(LED2_NODE, gpios);
 static const struct gpio_dt_spec led3 = GPIO_DT_SPEC_GET(LED3_NODE, gpios);
 
 
+#ifdef CONFIG_SIT_LED_ASYNC_INIT
+static void led_init_work_handler(struct k_work *work) {
+	gpio_pin_set_dt(&led0, 0);
+	gpio_pin_set_dt(&led1, 0);
+	gpio_pin_set_dt(&led2, 0);
+	gpio_pin_set_dt(&led3, 0);
+}
+
+static K_WORK_DELAYABLE_DEFINE(led_init_work, led_init_work_handler);
+#endif
+
 void sit_led_init(void) {
   
 	gpio_pin_configure_dt(&led0, GPIO_OUTPUT_ACTIVE);
 	gpio_pin_configure_dt(&led1, GPIO_OUTPUT_ACTIVE);
 	gpio_pin_configure_dt(&led2, GPIO_OUTPUT_ACTIVE);
 	gpio_pin_configure_dt(&led3, GPIO_OUTPUT_ACTIVE);
+#ifdef CONFIG_SIT_LED_ASYNC_INIT
+	// LEDs stay on for the blink, switched off by the work queue
+	k_work_schedule(&led_init_work, K_MSEC(1000));
+	return;
+#endif
 	gpio_pin_set_dt(&led0, 0);
 	gpio_pin_set_dt(&led1, 0);
 	gpio_pin_set_dt(&led2, 0);
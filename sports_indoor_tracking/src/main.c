@@ -34,6 +34,13 @@
 #include <sit/sit.h>
 #include <sit/sit_device.h>
 #include <sit/sit_config.h>
+#include <sit/sit_boot.h>
+#ifdef CONFIG_SIT_SETTINGS
+	#include <sit/sit_settings.h>
+#endif
+#ifdef CONFIG_SIT_SPI_BENCHMARK
+	#include <sit/sit_diagnostic.h>
+#endif
 #include <sit_led/sit_led.h>
 
 #include <sit_ble/ble_init.h>
@@ -46,20 +53,54 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/reboot.h>
 LOG_MODULE_REGISTER(sit_main, LOG_LEVEL_INF);
 
+#define INIT_FAIL_LED 0
+#define INIT_FAIL_BLINKS 20
+
+/* Never range with a failed DW3000, show the error and restart the board */
+void init_failed() {
+	LOG_ERR("DW3000 init failed, reboot");
+	for (uint8_t i = 0; i < INIT_FAIL_BLINKS; i++) {
+		sit_toggle_led(INIT_FAIL_LED);
+		k_msleep(100);
+	}
+	sys_reboot(SYS_REBOOT_COLD);
+}
+
 void initialization() {
 	uint8_t error = 0;
 
 	sit_led_init();
+	sit_boot_mark(boot_led);
+
+	#ifdef CONFIG_SIT_SETTINGS
+		// restore before sit_init(), it applies the antenna delays
+		if (sit_settings_init()) {
+			LOG_ERR("Settings restore failed");
+		}
+		sit_boot_mark(boot_settings);
+	#endif
 
 	if (sit_ble_init()) {
 		LOG_ERR("Bluetooth init failed");
 	}
 	// repeat configuration when failed
-	do {
+	for (uint8_t retry = 0; retry < CONFIG_SIT_INIT_RETRIES; retry++) {
 		error = sit_init();
-	} while (error > 1);
+		if (error <= 1) {
+			break;
+		}
+		LOG_WRN("DW3000 init failed (%d), retry %d", (int8_t)error, retry + 1);
+	}
+	if (error > 1) {
+		init_failed();
+	}
+	sit_boot_mark(boot_uwb);
+	#ifdef CONFIG_SIT_SPI_BENCHMARK
+		spi_read_benchmark();
+	#endif
 	
 	LOG_INF("Init Fertig ");
 }
@@ -67,6 +108,7 @@ void initialization() {
 int main(int argc, char *argv[])  {
 	printk(APP_NAME);
 	printk("==================\n");
+	sit_boot_mark(boot_main);
 	init_device_id();
 
 	initialization();